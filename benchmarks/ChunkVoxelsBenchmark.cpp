@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "ChunkVoxels.hpp"
+#include "ChunkCoord.hpp"
+#include "WaterSystem.hpp"
+
+// Compares the current ChunkVoxels::computeCubeData against a replica of the
+// original nested std::vector pipeline (light propagation, exposed cube scan
+// with Cube allocation, water surface flood fill).
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int CHUNK_RADIUS{1};
+constexpr int ITERATIONS{10};
+
+namespace legacy {
+// The old CubeType was a plain int-sized enum; keep 4-byte cells here.
+using Cell = std::int32_t;
+using VoxelGrid = std::vector<std::vector<std::vector<Cell>>>;
+using LightGrid = std::vector<std::vector<std::vector<float>>>;
+
+// The old per-voxel heap object: position, model matrix and type.
+struct Cube {
+    Cube(const glm::vec3& cubePosition, CubeType cubeType)
+        : position{cubePosition},
+          model{glm::translate(glm::mat4{1.0f}, cubePosition)},
+          type{cubeType} {}
+    glm::vec3 position;
+    glm::mat4 model;
+    CubeType type;
+};
+
+struct Result {
+    std::vector<std::unique_ptr<Cube>> cubes{};
+    std::unordered_map<CubeType, std::vector<glm::mat4>> matrices{};
+    std::vector<float> lightVolume{};
+    std::size_t waterQuads{0};
+};
+
+VoxelGrid copyGrid(const ChunkVoxels& voxels) {
+    VoxelGrid grid(CHUNK_SIZE, std::vector<std::vector<Cell>>(
+                                   CHUNK_SIZE, std::vector<Cell>(CHUNK_SIZE)));
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y)
+                grid[x][z][y] =
+                    static_cast<Cell>(voxels.getCubeTypeAt({x, y, z}));
+    return grid;
+}
+
+std::vector<float> computeLight(const VoxelGrid& grid,
+                                const std::vector<glm::ivec3>& torches) {
+    const int padded = CHUNK_SIZE + 2;
+    VoxelGrid voxels(padded, std::vector<std::vector<Cell>>(
+                                 padded, std::vector<Cell>(padded)));
+    LightGrid light(padded, std::vector<std::vector<float>>(
+                                padded, std::vector<float>(padded, 0.0f)));
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y)
+                voxels[x + 1][z + 1][y + 1] = grid[x][z][y];
+
+    std::queue<glm::ivec3> queue;
+    for (const auto& torch : torches) {
+        const auto pos = torch + glm::ivec3(1);
+        light[pos.x][pos.z][pos.y] = 1.0f;
+        queue.push(pos);
+    }
+    while (not queue.empty()) {
+        const auto pos = queue.front();
+        queue.pop();
+        const float next = light[pos.x][pos.z][pos.y] * 0.8f;
+        if (light[pos.x][pos.z][pos.y] < 0.01f) continue;
+        for (const auto& offset : NEIGHBOR_OFFSETS) {
+            const auto n = pos + offset;
+            if (not isPositionWithinBounds(n, padded)) continue;
+            if (next <= light[n.x][n.z][n.y]) continue;
+            light[n.x][n.z][n.y] = next;
+            if (voxels[n.x][n.z][n.y] == 0) queue.push(n);
+        }
+    }
+
+    std::vector<float> out;
+    out.reserve(CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE);
+    for (int z = 1; z <= CHUNK_SIZE; ++z)
+        for (int y = 1; y <= CHUNK_SIZE; ++y)
+            for (int x = 1; x <= CHUNK_SIZE; ++x)
+                out.push_back(light[x][z][y]);
+    return out;
+}
+
+bool isExposed(const VoxelGrid& grid, const glm::ivec3& pos) {
+    for (const auto& offset : NEIGHBOR_OFFSETS) {
+        const auto n = pos + offset;
+        if (not isPositionWithinBounds(n, CHUNK_SIZE)) return true;
+        const auto type = static_cast<CubeType>(grid[n.x][n.z][n.y]);
+        if (type == CubeType::NONE or WaterSystem::isWater(type)) return true;
+    }
+    return false;
+}
+
+std::size_t countWaterQuads(const VoxelGrid& grid) {
+    std::vector<std::vector<std::vector<bool>>> processed(
+        CHUNK_SIZE, std::vector<std::vector<bool>>(
+                        CHUNK_SIZE, std::vector<bool>(CHUNK_SIZE, false)));
+    const std::vector<glm::ivec3> horizontal{
+        {1, 0, 0}, {-1, 0, 0}, {0, 0, 1}, {0, 0, -1}};
+    std::size_t quads{0};
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                if (processed[x][z][y] or
+                    not WaterSystem::isWater(
+                        static_cast<CubeType>(grid[x][z][y])))
+                    continue;
+                std::queue<glm::ivec3> queue;
+                queue.push({x, y, z});
+                processed[x][z][y] = true;
+                while (not queue.empty()) {
+                    const auto pos = queue.front();
+                    queue.pop();
+                    ++quads;
+                    for (const auto& offset : horizontal) {
+                        const auto n = pos + offset;
+                        if (isPositionWithinBounds(n, CHUNK_SIZE) and
+                            not processed[n.x][n.z][n.y] and
+                            grid[n.x][n.z][n.y] == grid[x][z][y]) {
+                            processed[n.x][n.z][n.y] = true;
+                            queue.push(n);
+                        }
+                    }
+                }
+            }
+    return quads;
+}
+
+Result computeCubeData(const VoxelGrid& grid,
+                       const std::vector<glm::ivec3>& torches) {
+    Result result;
+    result.lightVolume = computeLight(grid, torches);
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                const auto type = static_cast<CubeType>(grid[x][z][y]);
+                if (type == CubeType::NONE or WaterSystem::isWater(type) or
+                    not isExposed(grid, {x, y, z}))
+                    continue;
+                auto cube = std::make_unique<Cube>(glm::vec3(x, y, z), type);
+                result.matrices[type].push_back(cube->model);
+                result.cubes.push_back(std::move(cube));
+            }
+    result.waterQuads = countWaterQuads(grid);
+    return result;
+}
+} // namespace legacy
+
+double measureMilliseconds(const std::function<void()>& action) {
+    double best{1e9};
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        action();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+} // namespace
+
+int main() {
+    const std::vector<glm::ivec3> torches{{10, 40, 10}, {40, 20, 50}};
+    double legacyTotal{0.0};
+    double currentTotal{0.0};
+
+    for (int x = -CHUNK_RADIUS; x <= CHUNK_RADIUS; ++x) {
+        for (int z = -CHUNK_RADIUS; z <= CHUNK_RADIUS; ++z) {
+            ChunkVoxels voxels({x, 0, z});
+            for (const auto& torch : torches) {
+                voxels.removeCube(torch);
+                voxels.addCube(torch, CubeType::TORCH);
+            }
+            const auto legacyGrid = legacy::copyGrid(voxels);
+
+            const auto legacyMs = measureMilliseconds([&]() {
+                auto data = legacy::computeCubeData(legacyGrid, torches);
+            });
+            const auto currentMs = measureMilliseconds(
+                [&]() { auto data = voxels.computeCubeData(); });
+            printf("chunk (%2d, %2d): nested %.2f ms, current %.2f ms\n", x, z,
+                   legacyMs, currentMs);
+            legacyTotal += legacyMs;
+            currentTotal += currentMs;
+        }
+    }
+
+    const auto cells = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+    const auto nestedBytes =
+        cells * sizeof(legacy::Cell) +
+        CHUNK_SIZE * (CHUNK_SIZE + 1) * sizeof(std::vector<legacy::Cell>);
+    printf("computeCubeData total: nested %.2f ms, current %.2f ms (%.2fx)\n",
+           legacyTotal, currentTotal, legacyTotal / currentTotal);
+    printf("voxel storage per chunk: nested %zu bytes (4-byte ids), "
+           "flat %zu bytes\n",
+           nestedBytes, cells * sizeof(CubeType));
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <tuple>
+#include <vector>
+#include <glm/geometric.hpp>
+#include "BlockRegistry.hpp"
+#include "ChunkCoord.hpp"
+#include "ChunkFaceMasks.hpp"
+#include "ChunkVoxels.hpp"
+#include "GreedyMesher.hpp"
+#include "LodDownsampler.hpp"
+
+// Compares ChunkVoxels::processVoxelGrid, built on the ChunkFaceMasks
+// bitmask kernel, against replicas of the scalar exposed-cube scans it
+// replaced: the plain scan testing the six neighbors of every voxel, and the
+// section-aware scan that skipped enclosed sections. Also times the greedy
+// quad path and the coarse levels of detail, and checks that their quads
+// cover exactly the visible faces of the grids they mesh.
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int SECTION_SIZE{VoxelTypes::VoxelGrid3D::SECTION_SIZE};
+constexpr int CHUNK_RADIUS{1};
+constexpr int ITERATIONS{20};
+constexpr int CHUNK_COUNT{(2 * CHUNK_RADIUS + 1) * (2 * CHUNK_RADIUS + 1)};
+
+namespace scalar {
+using Grid = VoxelTypes::VoxelGrid3D;
+
+bool isSolid(CubeType type) { return BlockRegistry::isSolid(type); }
+bool isOpaque(CubeType type) { return BlockRegistry::isOpaque(type); }
+
+bool isCubeExposed(const Grid& grid, const glm::ivec3& pos) {
+    for (const auto& offset : NEIGHBOR_OFFSETS) {
+        const auto neighbor = pos + offset;
+        if (not ChunkGeometry::isWithinChunk(neighbor) or
+            not isOpaque(grid[neighbor])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void emitCube(ChunkMesh& mesh, const glm::vec3& origin, int x, int y, int z,
+              CubeType type) {
+    mesh.instancePositions[type].push_back(origin + glm::vec3(x, y, z));
+}
+
+void plainScan(const Grid& grid, const glm::vec3& origin, ChunkMesh& mesh) {
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                const auto type = grid(x, y, z);
+                if (isSolid(type) and isCubeExposed(grid, {x, y, z}))
+                    emitCube(mesh, origin, x, y, z, type);
+            }
+}
+
+bool isUniformOpaqueSection(const Grid& grid, const glm::ivec3& pos) {
+    return ChunkGeometry::isWithinChunk(pos) and
+           grid.isUniformSectionAt(pos) and isOpaque(grid[pos]);
+}
+
+bool isSectionEnclosed(const Grid& grid, const glm::ivec3& pos) {
+    return std::all_of(NEIGHBOR_OFFSETS.cbegin(), NEIGHBOR_OFFSETS.cend(),
+                       [&](const glm::ivec3& offset) {
+                           return isUniformOpaqueSection(
+                               grid, pos + offset * SECTION_SIZE);
+                       });
+}
+
+bool isExposedWithinSection(const CubeType* cell) {
+    constexpr int X_STRIDE{Grid::SECTION_X_STRIDE};
+    constexpr int Z_STRIDE{Grid::SECTION_Z_STRIDE};
+    return not isOpaque(cell[1]) or not isOpaque(cell[-1]) or
+           not isOpaque(cell[Z_STRIDE]) or not isOpaque(cell[-Z_STRIDE]) or
+           not isOpaque(cell[X_STRIDE]) or not isOpaque(cell[-X_STRIDE]);
+}
+
+bool isSectionBoundaryColumn(int x, int z) {
+    const auto localX = x & Grid::SECTION_MASK;
+    const auto localZ = z & Grid::SECTION_MASK;
+    return localX == 0 or localX == SECTION_SIZE - 1 or localZ == 0 or
+           localZ == SECTION_SIZE - 1;
+}
+
+void sectionScan(const Grid& grid, const glm::vec3& origin, ChunkMesh& mesh) {
+    const auto visitCube = [&](int x, int y, int z) {
+        const auto type = grid(x, y, z);
+        if (isSolid(type) and isCubeExposed(grid, {x, y, z}))
+            emitCube(mesh, origin, x, y, z, type);
+    };
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int sectionY = 0; sectionY < CHUNK_SIZE;
+                 sectionY += SECTION_SIZE) {
+                const glm::ivec3 sectionPos{x, sectionY, z};
+                const auto lastY = sectionY + SECTION_SIZE - 1;
+                if (const auto* run = grid.sectionColumnAt(sectionPos)) {
+                    const bool isInnerColumn{not isSectionBoundaryColumn(x, z)};
+                    for (int localY = 0; localY < SECTION_SIZE; ++localY) {
+                        const auto type = run[localY];
+                        if (not isSolid(type)) continue;
+                        const bool isInnerCell{isInnerColumn and localY > 0 and
+                                               localY < SECTION_SIZE - 1};
+                        const auto y = sectionY + localY;
+                        if (isInnerCell ? isExposedWithinSection(run + localY)
+                                        : isCubeExposed(grid, {x, y, z}))
+                            emitCube(mesh, origin, x, y, z, type);
+                    }
+                    continue;
+                }
+                const auto uniformType = grid[sectionPos];
+                if (not isSolid(uniformType) or
+                    (isOpaque(uniformType) and
+                     isSectionEnclosed(grid, sectionPos)))
+                    continue;
+                if (isSectionBoundaryColumn(x, z) or
+                    not isOpaque(uniformType)) {
+                    for (int y = sectionY; y <= lastY; ++y) visitCube(x, y, z);
+                } else {
+                    visitCube(x, sectionY, z);
+                    visitCube(x, lastY, z);
+                }
+            }
+}
+} // namespace scalar
+
+double measureMilliseconds(const std::function<void()>& action) {
+    double best{1e9};
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        action();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+// The scans list instances column by column, the kernel section by section.
+bool isSameMesh(const ChunkMesh& expected, const ChunkMesh& actual) {
+    const auto sorted = [](const ChunkMesh& mesh) {
+        auto positions = mesh.instancePositions;
+        for (auto& [type, list] : positions)
+            std::sort(list.begin(), list.end(),
+                      [](const glm::vec3& a, const glm::vec3& b) {
+                          return std::tie(a.x, a.y, a.z) <
+                                 std::tie(b.x, b.y, b.z);
+                      });
+        return positions;
+    };
+    return sorted(expected) == sorted(actual);
+}
+
+int countVisibleFaces(const VoxelTypes::VoxelGrid3D& grid) {
+    ChunkFaceMasks masks;
+    masks.build(grid);
+    int faces{0};
+    for (int face = 0; face < ChunkFaceMasks::FACE_COUNT; ++face)
+        for (int x = 0; x < CHUNK_SIZE; ++x)
+            for (int z = 0; z < CHUNK_SIZE; ++z)
+                faces += std::popcount(masks.facesAt(
+                    static_cast<ChunkFaceMasks::Face>(face), x, z));
+    return faces;
+}
+
+// Each quad is four vertices; its area in whole block faces.
+int countQuadArea(const ChunkMesh& mesh) {
+    float area{0.0f};
+    for (std::size_t i = 0; i + 3 < mesh.quadVertices.size(); i += 4) {
+        const auto& corner = mesh.quadVertices[i].position;
+        area += glm::length(
+            glm::cross(mesh.quadVertices[i + 1].position - corner,
+                       mesh.quadVertices[i + 3].position - corner));
+    }
+    return static_cast<int>(area + 0.5f);
+}
+
+// What ChunkVoxels draws for a chunk at a coarse level.
+void buildCoarseQuads(const VoxelTypes::VoxelGrid3D& coarseGrid,
+                      const glm::vec3& origin, ChunkMesh& mesh) {
+    ChunkFaceMasks masks;
+    masks.build(coarseGrid);
+    GreedyMesher::buildQuads(coarseGrid, masks, origin, mesh);
+}
+} // namespace
+
+int main() {
+    double plainTotal{0.0};
+    double sectionTotal{0.0};
+    double bitmaskTotal{0.0};
+    double greedyTotal{0.0};
+    double sectionRemeshTotal{0.0};
+    std::size_t cubeTriangles{0};
+    std::size_t quadTriangles{0};
+    constexpr std::array COARSE_LEVELS{LodLevel::HALF, LodLevel::QUARTER};
+    std::array<double, COARSE_LEVELS.size()> coarseTotals{};
+    std::array<std::size_t, COARSE_LEVELS.size()> coarseTriangles{};
+    bool allMatch{true};
+    // The scalar scans treat every border face as visible.
+    const ChunkHalo noNeighbors{};
+
+    for (int x = -CHUNK_RADIUS; x <= CHUNK_RADIUS; ++x) {
+        for (int z = -CHUNK_RADIUS; z <= CHUNK_RADIUS; ++z) {
+            ChunkVoxels voxels({x, 0, z});
+            const auto snapshot = voxels.takeSnapshot();
+            const auto& grid = *snapshot.voxelGrid;
+            const auto& origin = snapshot.chunkOrigin;
+
+            ChunkMesh plainMesh;
+            ChunkMesh sectionMesh;
+            ChunkMesh bitmaskMesh;
+            ChunkMesh greedyMesh;
+            scalar::plainScan(grid, origin, plainMesh);
+            scalar::sectionScan(grid, origin, sectionMesh);
+            ChunkVoxels::processVoxelGrid(grid, noNeighbors, origin,
+                                          MeshingMode::INSTANCED_CUBES,
+                                          bitmaskMesh);
+            ChunkVoxels::processVoxelGrid(grid, noNeighbors, origin,
+                                          MeshingMode::GREEDY_QUADS,
+                                          greedyMesh);
+            const bool match{
+                isSameMesh(plainMesh, bitmaskMesh) and
+                isSameMesh(sectionMesh, bitmaskMesh) and
+                countQuadArea(greedyMesh) == countVisibleFaces(grid)};
+            cubeTriangles += bitmaskMesh.countTriangles();
+            quadTriangles += greedyMesh.countTriangles();
+            allMatch = allMatch and match;
+
+            const auto plainMs = measureMilliseconds([&]() {
+                ChunkMesh mesh;
+                scalar::plainScan(grid, origin, mesh);
+            });
+            const auto sectionMs = measureMilliseconds([&]() {
+                ChunkMesh mesh;
+                scalar::sectionScan(grid, origin, mesh);
+            });
+            const auto bitmaskMs = measureMilliseconds([&]() {
+                ChunkMesh mesh;
+                ChunkVoxels::processVoxelGrid(grid, noNeighbors, origin,
+                                              MeshingMode::INSTANCED_CUBES,
+                                              mesh);
+            });
+            const auto greedyMs = measureMilliseconds([&]() {
+                ChunkMesh mesh;
+                ChunkVoxels::processVoxelGrid(grid, noNeighbors, origin,
+                                              MeshingMode::GREEDY_QUADS,
+                                              mesh);
+            });
+            // An edit in the middle of a chunk dirties a single section.
+            const auto sectionRemeshMs = measureMilliseconds([&]() {
+                ChunkMesh mesh;
+                ChunkVoxels::processVoxelGrid(
+                    grid, noNeighbors, origin, MeshingMode::INSTANCED_CUBES,
+                    mesh, ChunkMesh::SectionMask{1} << 21);
+            });
+            printf("chunk (%2d, %2d): plain %.3f ms, sectioned %.3f ms, "
+                   "bitmask %.3f ms, greedy %.3f ms, one section %.3f ms%s\n",
+                   x, z, plainMs, sectionMs, bitmaskMs, greedyMs,
+                   sectionRemeshMs, match ? "" : " MISMATCH");
+            plainTotal += plainMs;
+            sectionTotal += sectionMs;
+            bitmaskTotal += bitmaskMs;
+            greedyTotal += greedyMs;
+            sectionRemeshTotal += sectionRemeshMs;
+
+            for (std::size_t i = 0; i < COARSE_LEVELS.size(); ++i) {
+                const auto coarseGrid = LodDownsampler::downsample(
+                    grid, snapshot.heightmap, COARSE_LEVELS[i]);
+                ChunkMesh coarseMesh;
+                buildCoarseQuads(coarseGrid, origin, coarseMesh);
+                if (countQuadArea(coarseMesh) !=
+                    countVisibleFaces(coarseGrid)) {
+                    printf("chunk (%2d, %2d): level %zu MISMATCH\n", x, z,
+                           i + 1);
+                    allMatch = false;
+                }
+                coarseTriangles[i] += coarseMesh.countTriangles();
+                coarseTotals[i] += measureMilliseconds([&]() {
+                    ChunkMesh mesh;
+                    buildCoarseQuads(
+                        LodDownsampler::downsample(grid, snapshot.heightmap,
+                                                   COARSE_LEVELS[i]),
+                        origin, mesh);
+                });
+            }
+        }
+    }
+
+    printf("processVoxelGrid total: plain %.2f ms, sectioned %.2f ms, "
+           "bitmask %.2f ms (%.1fx / %.1fx)\n",
+           plainTotal, sectionTotal, bitmaskTotal, plainTotal / bitmaskTotal,
+           sectionTotal / bitmaskTotal);
+    printf("greedy quads: %.2f ms, %zu triangles against %zu for instanced "
+           "cubes (%.1fx fewer)\n",
+           greedyTotal, quadTriangles, cubeTriangles,
+           static_cast<double>(cubeTriangles) / quadTriangles);
+    printf("one-section remesh: %.3f ms per chunk against %.3f ms for all "
+           "sections\n",
+           sectionRemeshTotal / CHUNK_COUNT, bitmaskTotal / CHUNK_COUNT);
+    printf("levels of detail: half %zu triangles in %.2f ms, quarter %zu "
+           "triangles in %.2f ms, against %zu for greedy quads\n",
+           coarseTriangles[0], coarseTotals[0], coarseTriangles[1],
+           coarseTotals[1], quadTriangles);
+    return allMatch ? 0 : 1;
+}
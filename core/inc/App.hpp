@@ -40,4 +40,6 @@ class App {
     float lastMouseYPos{0};
     bool firstMouse{true};
     CubeType selectedCubeType{CubeType::SAND};
+    // Meshing toggle fires once per press, not every frame the key is held
+    bool meshingToggleHeld{false};
 };
\ No newline at end of file
@@ -25,6 +25,10 @@ class Camera {
         return glm::lookAt(position, position + frontVec, upVec);
     }
     inline glm::mat4 getProjectionMatrix() const { return projectionMatrix; }
+    /** Same view, with a depth range of its own for the far-field terrain. */
+    inline glm::mat4 getHorizonProjectionMatrix() const {
+        return horizonProjectionMatrix;
+    }
     inline float getZoom() const { return zoom; }
     inline glm::vec3 getPosition() const { return position; }
     inline glm::vec3 getFront() const { return frontVec; }
@@ -57,4 +61,5 @@ class Camera {
     float screenWidth{0};
     float screenHeight{0};
     glm::mat4 projectionMatrix{0.0f};
+    glm::mat4 horizonProjectionMatrix{0.0f};
 };
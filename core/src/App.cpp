@@ -220,4 +220,15 @@ void App::processInput() {
         selectedCubeType = CubeType::TORCH;
         printf("Selected TORCH.\n");
     }
+
+    const bool meshingTogglePressed =
+        glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS;
+    if (meshingTogglePressed and not meshingToggleHeld) {
+        const auto nextMode =
+            gameWorld->getMeshingMode() == MeshingMode::INSTANCED_CUBES
+                ? MeshingMode::GREEDY_QUADS
+                : MeshingMode::INSTANCED_CUBES;
+        gameWorld->setMeshingMode(nextMode);
+    }
+    meshingToggleHeld = meshingTogglePressed;
 }
\ No newline at end of file
@@ -1,5 +1,17 @@
 #include "Camera.hpp"
 
+namespace {
+constexpr float NEAR_PLANE{0.25f};
+/** Past the corners of the loaded chunk window. */
+constexpr float FAR_PLANE{800.0f};
+/** The horizon starts past the chunk window, hundreds of blocks out, so its
+ * own projection can start well away from the camera and spend the depth
+ * precision out to its far edge. */
+constexpr float HORIZON_NEAR_PLANE{64.0f};
+/** Past the horizon tiles, which fade into the sky 2048 blocks out. */
+constexpr float HORIZON_FAR_PLANE{2100.0f};
+} // namespace
+
 Camera::Camera(unsigned int width, unsigned int height)
     : screenWidth{static_cast<float>(width)},
       screenHeight{static_cast<float>(height)} {
@@ -53,7 +65,10 @@ void Camera::processMouseScroll(float yoffset) {
 
 void Camera::calculateProjection() {
     projectionMatrix = glm::perspective(
-        glm::radians(zoom), screenWidth / screenHeight, 0.1f, 200.0f);
+        glm::radians(zoom), screenWidth / screenHeight, NEAR_PLANE, FAR_PLANE);
+    horizonProjectionMatrix =
+        glm::perspective(glm::radians(zoom), screenWidth / screenHeight,
+                         HORIZON_NEAR_PLANE, HORIZON_FAR_PLANE);
 }
 
 // calculates the front vector from the Camera's (updated) Euler Angles
@@ -4,12 +4,10 @@
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include "ChunkCoord.hpp"
+#include "ChunkWindowIndex.hpp"
 #include "RenderableChunk.hpp"
 #include "Camera.hpp"
 
-int floorDivide(int a, int b);
-int negativeSafeModulo(int a, int b);
-
 struct HitResult {
     glm::ivec3 position{};
     ChunkCoord chunkCoord{};
@@ -19,17 +17,16 @@ struct HitResult {
 
 class Raycaster {
    public:
-    Raycaster(const Camera& camera, int chunkSize);
+    explicit Raycaster(const Camera& camera);
     Raycaster(const Raycaster&) = delete;
     Raycaster(Raycaster&&) = delete;
     Raycaster& operator=(const Raycaster&) = delete;
     Raycaster& operator=(Raycaster&&) = delete;
     std::optional<HitResult> raycastDDA(
-        const Coord::RenderableChunksMap& loadedChunks, float maxDistance);
+        const ChunkWindowIndex& chunks, float maxDistance);
 
    private:
     void incrementRayStep();
-    int size{0};
     float distanceTraveled{0.0f};
     glm::ivec3 lastStep{0};
     glm::vec3 rayDirection{};
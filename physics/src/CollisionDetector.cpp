@@ -1,6 +1,5 @@
 #include "CollisionDetector.hpp"
 #include "SteveData.hpp"
-#include "WaterSystem.hpp"
 #include <cmath>
 
 namespace {
@@ -15,10 +14,6 @@ constexpr float STEP_CHECK_HEIGHT{1.1f};
 constexpr float STEP_CLEARANCE{0.01f};
 constexpr float MAX_STEP_HEIGHT{1.1f};
 
-bool isSolidForCollision(CubeType type) {
-    return type != CubeType::NONE and not WaterSystem::isWater(type);
-}
-
 bool isStepHeightReasonable(float requiredStepHeight) {
     return (requiredStepHeight <= MAX_STEP_HEIGHT);
 }
@@ -41,15 +36,12 @@ std::optional<float> CollisionDetector::getDistanceToGround(
     const int startY{static_cast<int>(std::floor(hitboxBottom))};
     const int endY{startY - MAX_GROUND_SEARCH_DISTANCE};
 
-    for (int y{startY}; y >= endY; --y) {
-        const glm::ivec3 checkPos{static_cast<int>(std::floor(hitboxCenter.x)),
-                                  y,
-                                  static_cast<int>(std::floor(hitboxCenter.z))};
-
-        if (isSolidForCollision(world.getCubeTypeAtPosition(checkPos))) {
-            const float groundSurfaceY{y + 1.0f};
-            return hitboxBottom - groundSurfaceY;
-        }
+    const auto groundY = world.findHighestSolidY(
+        static_cast<int>(std::floor(hitboxCenter.x)),
+        static_cast<int>(std::floor(hitboxCenter.z)), endY, startY);
+    if (groundY.has_value()) {
+        const float groundSurfaceY{*groundY + 1.0f};
+        return hitboxBottom - groundSurfaceY;
     }
 
     return std::nullopt;
@@ -61,7 +53,7 @@ bool CollisionDetector::checkCollisionAtPoints(
         const glm::ivec3 checkPos{static_cast<int>(std::floor(point.x)),
                                   static_cast<int>(std::floor(point.y)),
                                   static_cast<int>(std::floor(point.z))};
-        if (isSolidForCollision(world.getCubeTypeAtPosition(checkPos))) {
+        if (world.isSolidAt(checkPos)) {
             return true;
         }
     }
@@ -102,18 +94,13 @@ std::vector<glm::vec3> CollisionDetector::getCollisionPoints(
 std::optional<glm::ivec3> CollisionDetector::isObstacleAt(
     const World& world, const glm::vec3& frontPosition,
     float currentHitboxBottom) const {
-    for (int checkY = static_cast<int>(std::floor(currentHitboxBottom));
-         checkY <=
-         static_cast<int>(std::floor(currentHitboxBottom + STEP_CHECK_HEIGHT));
-         checkY++) {
-        const glm::ivec3 checkPos(
-            static_cast<int>(std::floor(frontPosition.x)), checkY,
-            static_cast<int>(std::floor(frontPosition.z)));
-
-        const auto cubeType = world.getCubeTypeAtPosition(checkPos);
-        if (isSolidForCollision(cubeType)) {
-            return checkPos;
-        }
+    const int checkX{static_cast<int>(std::floor(frontPosition.x))};
+    const int checkZ{static_cast<int>(std::floor(frontPosition.z))};
+    const auto obstacleY = world.findLowestSolidY(
+        checkX, checkZ, static_cast<int>(std::floor(currentHitboxBottom)),
+        static_cast<int>(std::floor(currentHitboxBottom + STEP_CHECK_HEIGHT)));
+    if (obstacleY.has_value()) {
+        return glm::ivec3{checkX, *obstacleY, checkZ};
     }
     return std::nullopt;
 }
@@ -138,9 +125,7 @@ bool CollisionDetector::hasObstacleGroundSupport(
     const glm::ivec3 groundCheckPos(
         static_cast<int>(std::floor(frontPosition.x)), groundCheckY,
         static_cast<int>(std::floor(frontPosition.z)));
-    const auto groundCubeType = world.getCubeTypeAtPosition(groundCheckPos);
-
-    return isSolidForCollision(groundCubeType);
+    return world.isSolidAt(groundCheckPos);
 }
 
 bool CollisionDetector::hasCurrentGroundSupport(
@@ -151,10 +136,7 @@ bool CollisionDetector::hasCurrentGroundSupport(
     const glm::ivec3 currentGroundPos(static_cast<int>(std::floor(position.x)),
                                       currentGroundY,
                                       static_cast<int>(std::floor(position.z)));
-    const auto currentGroundType =
-        world.getCubeTypeAtPosition(currentGroundPos);
-
-    return isSolidForCollision(currentGroundType);
+    return world.isSolidAt(currentGroundPos);
 }
 
 bool CollisionDetector::hasValidGroundSupport(const World& world,
@@ -214,11 +196,7 @@ bool CollisionDetector::isColliding(const World& world,
                               static_cast<int>(std::floor(point.y)),
                               static_cast<int>(std::floor(point.z)));
 
-    const auto cubeType = world.getCubeTypeAtPosition(checkPos);
-    if (isSolidForCollision(cubeType)) {
-        return true;
-    }
-    return false;
+    return world.isSolidAt(checkPos);
 }
 
 std::optional<float> CollisionDetector::getStepUpHeight(
@@ -272,9 +250,7 @@ glm::vec3 CollisionDetector::tryHorizontalMovement(
         static_cast<int>(std::floor(frontCheckPosition.y)),
         static_cast<int>(std::floor(frontCheckPosition.z)));
 
-    const auto cubeType = world.getCubeTypeAtPosition(frontCheckPos);
-
-    if (isSolidForCollision(cubeType)) {
+    if (world.isSolidAt(frontCheckPos)) {
         const auto stepUpHeight =
             getStepUpHeight(world, position, horizontalDirection);
         if (stepUpHeight.has_value()) {
@@ -319,14 +295,11 @@ std::optional<float> CollisionDetector::findGroundSurfaceForSnapping(
     const int startY = static_cast<int>(center.y);
     const int endY = startY - SNAP_SEARCH_DISTANCE;
 
-    for (int y = startY; y >= endY; y--) {
-        const glm::ivec3 checkPos(static_cast<int>(std::floor(center.x)), y,
-                                  static_cast<int>(std::floor(center.z)));
-
-        const auto cubeType = world.getCubeTypeAtPosition(checkPos);
-        if (isSolidForCollision(cubeType)) {
-            return static_cast<float>(y + 1);
-        }
+    const auto groundY = world.findHighestSolidY(
+        static_cast<int>(std::floor(center.x)),
+        static_cast<int>(std::floor(center.z)), endY, startY);
+    if (groundY.has_value()) {
+        return static_cast<float>(*groundY + 1);
     }
 
     return std::nullopt;
@@ -22,25 +22,10 @@ glm::vec3 computeDistanceToNextVoxel(const glm::vec3& origin,
 glm::vec3 computeboundaryStepIncrement(const glm::vec3& rayDir) {
     return glm::abs(1.0f / rayDir);
 }
-
-RenderableChunk* findChunkAtCurrentRayPos(
-    const Coord::RenderableChunksMap& loadedChunks, const ChunkCoord& coords) {
-    auto loadedChunk = loadedChunks.find(coords);
-    return (loadedChunk != loadedChunks.end()) ? loadedChunk->second.get()
-                                               : nullptr;
-}
 } // namespace
 
-int floorDivide(int a, int b) { return (a >= 0) ? (a / b) : ((a - b + 1) / b); }
-
-int negativeSafeModulo(int a, int b) {
-    const int remainder{a % b};
-    return (remainder < 0) ? remainder + b : remainder;
-}
-
-Raycaster::Raycaster(const Camera& camera, int chunkSize)
-    : size{chunkSize},
-      rayDir{glm::normalize(glm::normalize(camera.getFront()))},
+Raycaster::Raycaster(const Camera& camera)
+    : rayDir{glm::normalize(glm::normalize(camera.getFront()))},
       blockPos{computeInitialBlockPos(camera.getPosition())} {
     step = computeStep(rayDir);
     nextVoxelBoundary = computeDistanceToNextVoxel(camera.getPosition(),
@@ -49,21 +34,22 @@ Raycaster::Raycaster(const Camera& camera, int chunkSize)
 }
 
 std::optional<HitResult> Raycaster::raycastDDA(
-    const Coord::RenderableChunksMap& loadedChunks, float maxDistance) {
+    const ChunkWindowIndex& chunks, float maxDistance) {
     distanceTraveled = 0.0f;
+    // Consecutive steps mostly stay in one chunk; look it up once per chunk.
+    auto coord = fromWorldPosition(blockPos);
+    const RenderableChunk* chunk = chunks.find(coord);
 
     while (distanceTraveled < maxDistance) {
-        const auto chunkX = floorDivide(blockPos.x, size);
-        const auto chunkZ = floorDivide(blockPos.z, size);
-        const ChunkCoord coord{chunkX, chunkZ};
-        const RenderableChunk* chunk =
-            findChunkAtCurrentRayPos(loadedChunks, coord);
+        if (const auto stepCoord = fromWorldPosition(blockPos);
+            stepCoord != coord) {
+            coord = stepCoord;
+            chunk = chunks.find(coord);
+        }
         if (chunk) {
-            const auto localX = negativeSafeModulo(blockPos.x, size);
-            const auto localZ = negativeSafeModulo(blockPos.z, size);
-            const auto localY = blockPos.y;
-            if (localY >= 0 and localY < size and
-                chunk->isCubeInGrid({localX, localY, localZ})) {
+            const auto localPos = toLocalPosition(blockPos);
+            if (ChunkGeometry::isWithinChunk(localPos) and
+                chunk->isCubeInGrid(localPos)) {
                 const bool isHit{true};
                 const auto normal = -lastStep;
                 return HitResult{blockPos, coord, normal, isHit};
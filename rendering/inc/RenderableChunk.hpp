@@ -4,11 +4,10 @@
 #include "ChunkGraphics.hpp"
 #include "CubeData.hpp"
 #include "Frustum.hpp"
+#include "RetainedMesh.hpp"
 #include "VoxelTypes.hpp"
 #include "RenderableWaterMesh.hpp"
 
-class CpuChunk;
-
 class RenderableChunk {
    public:
     RenderableChunk(ChunkVoxels&& voxelsData, unsigned sharedVBO,
@@ -19,27 +18,61 @@ class RenderableChunk {
     RenderableChunk& operator=(const RenderableChunk&) = delete;
     RenderableChunk(RenderableChunk&&) = delete;
     RenderableChunk& operator=(RenderableChunk&&) = delete;
-    std::unique_ptr<CpuChunk> toCpuChunk();
+    std::optional<SavedChunk> save() const;
     bool addCube(const glm::ivec3& localPos, CubeType type);
     bool removeCube(const glm::ivec3& localPos);
+    ChunkVoxels::BulkWriteResult writeVoxels(
+        const std::vector<VoxelTypes::VoxelWrite>& writes);
     bool isCubeInGrid(const glm::ivec3& localPos) const;
+    /** True when the chunk needs a rebuild. An all-air chunk that has not
+     * drawn anything yet needs none, and gets no GPU resources until an
+     * edit gives it a block. */
     bool isModified() const;
-    bool isValidCubeAt(const glm::ivec3& pos) const;
     CubeType getCubeType(const glm::ivec3& pos) const;
+    Voxel getVoxel(const glm::ivec3& pos) const;
+    bool setBlockState(const glm::ivec3& localPos, BlockState state);
+    void readColumn(int localX, int localZ, CubeType* out) const;
+    int getSurfaceHeight(int localX, int localZ) const;
+    const ChunkOccupancy& getOccupancy() const;
     void markModified();
-    void setNeighborsSurroundingCubes(VoxelTypes::NeighborVoxelsMap&& data);
-    void clearNeighborsSurroundingCubes();
+    void markBorderModified();
+    void setMeshingMode(MeshingMode mode);
+    void setLodLevel(LodLevel level);
+    LodLevel getLodLevel() const;
+    /** Triangles this chunk draws, 0 while frustum culled. */
+    std::size_t getTriangleCount() const;
+    void setNeighborHalo(const ChunkHalo& halo);
+    void setOpenBorderFaces(ChunkFaceMasks::FaceSet faces);
     glm::vec3 getChunkCenter() const;
-    CubeData computeCubeData();
+    ChunkSnapshot takeSnapshot();
     void applyCubeData(CubeData&& data);
-    void createWaterMeshes();
+    /** Hands over the CPU copy of what the chunk draws, for a chunk about
+     * to be evicted; empty while a rebuild is pending or running. */
+    std::optional<RetainedMesh> releaseMesh();
+    /** Draws mesh, retained when this chunk was last evicted, with uploads
+     * alone; the chunk is not rebuilt until it changes again. */
+    void adoptMesh(RetainedMesh&& mesh);
+    /** Sides whose neighbor the adopted mesh was built against but which is
+     * not loaded yet; that neighbor's arrival changes nothing here. */
+    void assumeNeighbors(ChunkFaceMasks::FaceSet faces);
+    /** True, once, if the neighbor on face was assumed. */
+    bool consumeAssumedNeighbor(int face);
     void renderByType(Shader& shader, CubeType type);
     void renderWaterMeshes(Shader& shader);
     void performFrustumCulling(const Frustum& frustum);
 
    private:
+    /** Creates the GL objects on the first mesh there is to draw. */
+    void ensureGraphics();
+
     ChunkVoxels voxels;
+    unsigned sharedVertexBuffer{0};
+    unsigned sharedCubeIndices{0};
+    unsigned sharedWaterIndices{0};
+    bool hasGraphics{false};
     ChunkGraphics graphics;
-    std::vector<RenderableWaterMesh> waterMeshes{};
+    RenderableWaterMesh waterMesh{};
+    RetainedMesh retained{};
+    ChunkFaceMasks::FaceSet assumedNeighbors{0};
     bool isCulled{false};
 };
@@ -0,0 +1,29 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glad/glad.h>
+#include "HorizonMeshBuilder.hpp"
+
+class RenderableHorizonTile {
+   public:
+    explicit RenderableHorizonTile(const CpuHorizonMesh& data);
+    ~RenderableHorizonTile();
+
+    RenderableHorizonTile(const RenderableHorizonTile&) = delete;
+    RenderableHorizonTile& operator=(const RenderableHorizonTile&) = delete;
+    RenderableHorizonTile(RenderableHorizonTile&& other) noexcept;
+    RenderableHorizonTile& operator=(RenderableHorizonTile&& other) noexcept;
+
+    void render() const;
+    glm::vec3 getBoundsMin() const { return boundsMin; }
+    glm::vec3 getBoundsMax() const { return boundsMax; }
+
+   private:
+    void cleanup();
+
+    GLuint VertexArrayObject{0};
+    GLuint VertexBufferObject{0};
+    GLuint ElementBufferObject{0};
+    unsigned int indexCount{0};
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+};
@@ -1,12 +1,12 @@
 #pragma once
-#include <vector>
-#include <glm/vec3.hpp>
 #include <glad/glad.h>
-#include "Cube.hpp"
 #include "CpuWaterMesh.hpp"
 
+/** The water of one chunk on the GPU: one vertex and one index buffer,
+ * drawn with a single call. */
 class RenderableWaterMesh {
    public:
+    RenderableWaterMesh() = default;
     explicit RenderableWaterMesh(const CpuWaterMesh& data);
     ~RenderableWaterMesh();
 
@@ -15,18 +15,17 @@ class RenderableWaterMesh {
     RenderableWaterMesh(RenderableWaterMesh&& other) noexcept;
     RenderableWaterMesh& operator=(RenderableWaterMesh&& other) noexcept;
 
+    /** Replaces the contents of the buffers, creating them on first use. */
+    void upload(const CpuWaterMesh& data);
     void render() const;
-    CubeType getWaterType() const { return waterType; }
-    glm::vec3 getCenter() const { return center; }
     bool isEmpty() const { return indexCount == 0; }
 
    private:
+    void createBuffers();
     void cleanup();
 
     GLuint VertexArrayObject{0};
     GLuint VertexBufferObject{0};
     GLuint ElementBufferObject{0};
     unsigned int indexCount{0};
-    CubeType waterType{CubeType::WATER_SOURCE};
-    glm::vec3 center{0.0f};
 };
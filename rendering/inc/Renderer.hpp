@@ -26,6 +26,7 @@ class Renderer {
    private:
     void applyCubeShaderInitialConfig();
     void applyWaterShaderInitialConfig();
+    void applyHorizonShaderInitialConfig();
     void setupDirectionalLightConfig();
     void setupWaterTintConfig();
     void updateWaterShaderParams(const Camera& camera);
@@ -41,11 +42,13 @@ class Renderer {
 
     std::unique_ptr<Shader> cubeShader{nullptr};
     std::unique_ptr<Shader> waterShader{nullptr};
+    std::unique_ptr<Shader> horizonShader{nullptr};
     std::unique_ptr<Shader> lightCubeShader{nullptr};
     std::unique_ptr<Shader> crosshairShader{nullptr};
     std::unique_ptr<Crosshair> crosshair{nullptr};
     std::unique_ptr<StatusTextRenderer> statusTextRenderer{nullptr};
     Materials materials{};
     Frustum frustum{};
+    Frustum horizonFrustum{};
     glm::vec3 lastCameraPosition{0.0f, 0.0f, 0.0f};
 };
\ No newline at end of file
@@ -13,6 +13,13 @@ struct EntityVertex {
     glm::vec2 texCoord{};
 };
 
+/** Untextured, shaded by a color per vertex. */
+struct HorizonVertex {
+    glm::vec3 position{};
+    glm::vec3 normal{};
+    glm::vec3 color{};
+};
+
 // clang-format off
 //Pos: {X, Y, Z}
 const std::vector<glm::vec3> cubeVertices = {
@@ -1,14 +1,30 @@
 #include "RenderableChunk.hpp"
-#include "CpuChunk.hpp"
+#include <utility>
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+} // namespace
 
 RenderableChunk::RenderableChunk(ChunkVoxels&& voxelsData, unsigned sharedVBO,
                                  unsigned sharedCubeEBO,
                                  unsigned sharedWaterEBO)
-    : voxels(std::move(voxelsData)) {
-    graphics.initializeGL(sharedVBO, sharedCubeEBO, sharedWaterEBO,
-                          voxels.getSize());
+    : voxels(std::move(voxelsData)),
+      sharedVertexBuffer(sharedVBO),
+      sharedCubeIndices(sharedCubeEBO),
+      sharedWaterIndices(sharedWaterEBO) {
+    // The layers of air above the terrain stay without GPU resources.
+    if (not voxels.isAllAir()) {
+        ensureGraphics();
+    }
+    waterMesh.upload(voxels.getWaterMesh());
+}
 
-    createWaterMeshes();
+void RenderableChunk::ensureGraphics() {
+    if (not hasGraphics) {
+        graphics.initializeGL(sharedVertexBuffer, sharedCubeIndices,
+                              sharedWaterIndices, CHUNK_SIZE);
+        hasGraphics = true;
+    }
 }
 
 bool RenderableChunk::addCube(const glm::ivec3& position, CubeType type) {
@@ -17,81 +33,156 @@ bool RenderableChunk::addCube(const glm::ivec3& position, CubeType type) {
 bool RenderableChunk::removeCube(const glm::ivec3& position) {
     return voxels.removeCube(position);
 }
+ChunkVoxels::BulkWriteResult RenderableChunk::writeVoxels(
+    const std::vector<VoxelTypes::VoxelWrite>& writes) {
+    return voxels.writeVoxels(writes);
+}
 bool RenderableChunk::isCubeInGrid(const glm::ivec3& position) const {
     return voxels.isCubeInGrid(position);
 }
-bool RenderableChunk::isModified() const { return voxels.isModified(); }
-
-bool RenderableChunk::isValidCubeAt(const glm::ivec3& position) const {
-    const int size = voxels.getSize();
-    if (position.x < 0 or position.x >= size or position.y < 0 or
-        position.y >= size or position.z < 0 or position.z >= size) {
-        return false;
-    }
-    return voxels.isCubeInGrid(position);
+bool RenderableChunk::isModified() const {
+    return voxels.isModified() and (hasGraphics or not voxels.isAllAir());
 }
 
 CubeType RenderableChunk::getCubeType(const glm::ivec3& position) const {
     return voxels.getCubeTypeAt(position);
 }
 
-CubeData RenderableChunk::computeCubeData() { return voxels.computeCubeData(); }
+Voxel RenderableChunk::getVoxel(const glm::ivec3& position) const {
+    return voxels.getVoxelAt(position);
+}
+
+bool RenderableChunk::setBlockState(const glm::ivec3& position,
+                                    BlockState state) {
+    return voxels.setBlockState(position, state);
+}
+
+void RenderableChunk::readColumn(int localX, int localZ, CubeType* out) const {
+    voxels.readColumn(localX, localZ, out);
+}
+
+int RenderableChunk::getSurfaceHeight(int localX, int localZ) const {
+    return voxels.getSurfaceHeight(localX, localZ);
+}
+
+const ChunkOccupancy& RenderableChunk::getOccupancy() const {
+    return voxels.getOccupancy();
+}
+
+ChunkSnapshot RenderableChunk::takeSnapshot() {
+    // The new halo holds whatever neighbors are loaded by now.
+    assumedNeighbors = 0;
+    return voxels.takeSnapshot();
+}
+
+std::optional<SavedChunk> RenderableChunk::save() const {
+    return voxels.save();
+}
+
+void RenderableChunk::markModified() { voxels.markModified(); }
+
+void RenderableChunk::markBorderModified() { voxels.markBorderModified(); }
+
+void RenderableChunk::setMeshingMode(MeshingMode mode) {
+    voxels.setMeshingMode(mode);
+}
 
-std::unique_ptr<CpuChunk> RenderableChunk::toCpuChunk() {
-    return std::make_unique<CpuChunk>(std::move(voxels));
+void RenderableChunk::setLodLevel(LodLevel level) {
+    voxels.setLodLevel(level);
 }
 
-void RenderableChunk::markModified() { voxels.setModified(true); }
+LodLevel RenderableChunk::getLodLevel() const { return voxels.getLodLevel(); }
 
-void RenderableChunk::setNeighborsSurroundingCubes(
-    VoxelTypes::NeighborVoxelsMap&& data) {
-    voxels.setNeighborsSurroundingCubes(std::move(data));
+std::size_t RenderableChunk::getTriangleCount() const {
+    return isCulled ? 0 : graphics.getTriangleCount();
 }
 
-void RenderableChunk::clearNeighborsSurroundingCubes() {
-    voxels.clearNeighborsSurroundingCubes();
+void RenderableChunk::setNeighborHalo(const ChunkHalo& halo) {
+    voxels.setNeighborHalo(halo);
+}
+
+void RenderableChunk::setOpenBorderFaces(ChunkFaceMasks::FaceSet faces) {
+    voxels.setOpenBorderFaces(faces);
 }
 
 glm::vec3 RenderableChunk::getChunkCenter() const {
-    return voxels.getChunkOrigin() + glm::vec3(voxels.getSize() / 2.0f);
+    return voxels.getChunkOrigin() + glm::vec3(CHUNK_SIZE / 2.0f);
 }
 
 void RenderableChunk::applyCubeData(CubeData&& data) {
-    voxels.storeCubes(std::move(data.cubes));
-    graphics.updateInstanceData(data.instanceModelMatrices);
-    graphics.updateLightVolume(data.lightVolume, voxels.getSize());
-    voxels.setModified(false);
-    createWaterMeshes();
-}
-
-void RenderableChunk::createWaterMeshes() {
-    waterMeshes.clear();
-    const auto& waterMeshData = voxels.getWaterMeshData();
-    waterMeshes.reserve(waterMeshData.size());
-    for (const auto& data : waterMeshData) {
-        if (not data.isEmpty()) {
-            waterMeshes.emplace_back(data);
-        }
+    if (not voxels.acceptRebuild(data.version)) {
+        return;
+    }
+    ensureGraphics();
+    voxels.compactSections();
+    graphics.updateInstanceData(data.mesh);
+    if (data.scope != RebuildScope::SECTIONS) {
+        graphics.updateQuadData(data.mesh);
+    }
+    if (data.scope == RebuildScope::FULL) {
+        graphics.updateLightVolume(data.lightVolume, CHUNK_SIZE);
+        waterMesh.upload(data.waterMesh);
+    }
+    if (data.scope != RebuildScope::MESH) {
+        graphics.updateSurfaceHeights(data.heightmap);
     }
+    retained.apply(std::move(data));
+}
+
+std::optional<RetainedMesh> RenderableChunk::releaseMesh() {
+    if (retained.version == 0 or not voxels.isRebuildCurrent()) {
+        return std::nullopt;
+    }
+    retained.meshingMode = voxels.getMeshingMode();
+    retained.lodLevel = voxels.getLodLevel();
+    retained.openBorderFaces = voxels.getOpenBorderFaces();
+    retained.compact();
+    return std::exchange(retained, RetainedMesh{});
+}
+
+void RenderableChunk::adoptMesh(RetainedMesh&& mesh) {
+    voxels.adoptRebuild(mesh.version, mesh.meshingMode, mesh.lodLevel,
+                        mesh.openBorderFaces);
+    ensureGraphics();
+    voxels.compactSections();
+    graphics.updateInstanceData(mesh.mesh);
+    graphics.updateQuadData(mesh.mesh);
+    if (mesh.lightVolume.empty()) {
+        graphics.clearLightVolume();
+    } else {
+        graphics.updateLightVolume(mesh.lightVolume, CHUNK_SIZE);
+    }
+    graphics.updateSurfaceHeights(mesh.heightmap);
+    waterMesh.upload(mesh.waterMesh);
+    retained = std::move(mesh);
+}
+
+void RenderableChunk::assumeNeighbors(ChunkFaceMasks::FaceSet faces) {
+    assumedNeighbors = faces;
+}
+
+bool RenderableChunk::consumeAssumedNeighbor(int face) {
+    const ChunkFaceMasks::FaceSet bit{
+        static_cast<ChunkFaceMasks::FaceSet>(1 << face)};
+    const bool assumed{(assumedNeighbors & bit) != 0};
+    assumedNeighbors &= ~bit;
+    return assumed;
 }
 
 void RenderableChunk::renderByType(Shader& shader, CubeType type) {
-    if (not isCulled) {
+    if (not isCulled and hasGraphics) {
         shader.setVec3("chunkOrigin", voxels.getChunkOrigin());
-        shader.setFloat("chunkSize", float(voxels.getSize()));
+        shader.setFloat("chunkSize", float(CHUNK_SIZE));
         graphics.renderByType(type);
     }
 }
 
 void RenderableChunk::renderWaterMeshes(Shader& shader) {
-    if (not isCulled) {
+    if (not isCulled and not waterMesh.isEmpty()) {
         shader.setVec3("chunkOrigin", voxels.getChunkOrigin());
-        shader.setFloat("chunkSize", float(voxels.getSize()));
-        for (const auto& waterMesh : waterMeshes) {
-            if (not waterMesh.isEmpty()) {
-                waterMesh.render();
-            }
-        }
+        shader.setFloat("chunkSize", float(CHUNK_SIZE));
+        graphics.bindTextures();
+        waterMesh.render();
     }
 }
 
@@ -0,0 +1,99 @@
+#include "RenderableHorizonTile.hpp"
+#include <utility>
+#include "VertexData.hpp"
+
+RenderableHorizonTile::RenderableHorizonTile(const CpuHorizonMesh& data)
+    : indexCount(static_cast<unsigned int>(data.indices.size())),
+      boundsMin(data.boundsMin),
+      boundsMax(data.boundsMax) {
+    if (not data.vertices.empty() and not data.indices.empty()) {
+        glGenVertexArrays(1, &VertexArrayObject);
+        glGenBuffers(1, &VertexBufferObject);
+        glGenBuffers(1, &ElementBufferObject);
+
+        glBindVertexArray(VertexArrayObject);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VertexBufferObject);
+        glBufferData(GL_ARRAY_BUFFER,
+                     data.vertices.size() * sizeof(HorizonVertex),
+                     data.vertices.data(), GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBufferObject);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     data.indices.size() * sizeof(unsigned int),
+                     data.indices.data(), GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(HorizonVertex),
+                              (void*)offsetof(HorizonVertex, position));
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(HorizonVertex),
+                              (void*)offsetof(HorizonVertex, normal));
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(HorizonVertex),
+                              (void*)offsetof(HorizonVertex, color));
+        glEnableVertexAttribArray(2);
+
+        glBindVertexArray(0);
+    }
+}
+
+RenderableHorizonTile::~RenderableHorizonTile() { cleanup(); }
+
+RenderableHorizonTile::RenderableHorizonTile(
+    RenderableHorizonTile&& other) noexcept
+    : VertexArrayObject(other.VertexArrayObject),
+      VertexBufferObject(other.VertexBufferObject),
+      ElementBufferObject(other.ElementBufferObject),
+      indexCount(other.indexCount),
+      boundsMin(other.boundsMin),
+      boundsMax(other.boundsMax) {
+    other.VertexArrayObject = 0;
+    other.VertexBufferObject = 0;
+    other.ElementBufferObject = 0;
+    other.indexCount = 0;
+}
+
+RenderableHorizonTile& RenderableHorizonTile::operator=(
+    RenderableHorizonTile&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+
+        VertexArrayObject = other.VertexArrayObject;
+        VertexBufferObject = other.VertexBufferObject;
+        ElementBufferObject = other.ElementBufferObject;
+        indexCount = other.indexCount;
+        boundsMin = other.boundsMin;
+        boundsMax = other.boundsMax;
+
+        other.VertexArrayObject = 0;
+        other.VertexBufferObject = 0;
+        other.ElementBufferObject = 0;
+        other.indexCount = 0;
+    }
+    return *this;
+}
+
+void RenderableHorizonTile::render() const {
+    if (indexCount > 0 and VertexArrayObject != 0) {
+        glBindVertexArray(VertexArrayObject);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+    }
+}
+
+void RenderableHorizonTile::cleanup() {
+    if (VertexArrayObject != 0) {
+        glDeleteVertexArrays(1, &VertexArrayObject);
+        VertexArrayObject = 0;
+    }
+    if (VertexBufferObject != 0) {
+        glDeleteBuffers(1, &VertexBufferObject);
+        VertexBufferObject = 0;
+    }
+    if (ElementBufferObject != 0) {
+        glDeleteBuffers(1, &ElementBufferObject);
+        ElementBufferObject = 0;
+    }
+}
@@ -1,44 +1,8 @@
 #include "RenderableWaterMesh.hpp"
-#include <utility>
 #include "VertexData.hpp"
 
-RenderableWaterMesh::RenderableWaterMesh(const CpuWaterMesh& data)
-    : indexCount(static_cast<unsigned int>(data.getIndices().size())),
-      waterType(data.getWaterType()),
-      center(data.getCenter()) {
-    const auto& meshVertices = data.getVertices();
-    const auto& meshIndices = data.getIndices();
-
-    if (not meshVertices.empty() and not meshIndices.empty()) {
-        glGenVertexArrays(1, &VertexArrayObject);
-        glGenBuffers(1, &VertexBufferObject);
-        glGenBuffers(1, &ElementBufferObject);
-
-        glBindVertexArray(VertexArrayObject);
-
-        glBindBuffer(GL_ARRAY_BUFFER, VertexBufferObject);
-        glBufferData(GL_ARRAY_BUFFER, meshVertices.size() * sizeof(Vertex),
-                     meshVertices.data(), GL_STATIC_DRAW);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBufferObject);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     meshIndices.size() * sizeof(unsigned int),
-                     meshIndices.data(), GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              (void*)offsetof(Vertex, position));
-        glEnableVertexAttribArray(0);
-
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              (void*)offsetof(Vertex, texCoord));
-        glEnableVertexAttribArray(1);
-
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                              (void*)offsetof(Vertex, normal));
-        glEnableVertexAttribArray(2);
-
-        glBindVertexArray(0);
-    }
+RenderableWaterMesh::RenderableWaterMesh(const CpuWaterMesh& data) {
+    upload(data);
 }
 
 RenderableWaterMesh::~RenderableWaterMesh() { cleanup(); }
@@ -47,9 +11,7 @@ RenderableWaterMesh::RenderableWaterMesh(RenderableWaterMesh&& other) noexcept
     : VertexArrayObject(other.VertexArrayObject),
       VertexBufferObject(other.VertexBufferObject),
       ElementBufferObject(other.ElementBufferObject),
-      indexCount(other.indexCount),
-      waterType(other.waterType),
-      center(other.center) {
+      indexCount(other.indexCount) {
     other.VertexArrayObject = 0;
     other.VertexBufferObject = 0;
     other.ElementBufferObject = 0;
@@ -65,8 +27,6 @@ RenderableWaterMesh& RenderableWaterMesh::operator=(
         VertexBufferObject = other.VertexBufferObject;
         ElementBufferObject = other.ElementBufferObject;
         indexCount = other.indexCount;
-        waterType = other.waterType;
-        center = other.center;
 
         other.VertexArrayObject = 0;
         other.VertexBufferObject = 0;
@@ -76,6 +36,55 @@ RenderableWaterMesh& RenderableWaterMesh::operator=(
     return *this;
 }
 
+void RenderableWaterMesh::upload(const CpuWaterMesh& data) {
+    const auto& meshVertices = data.getVertices();
+    const auto& meshIndices = data.getIndices();
+    indexCount = static_cast<unsigned int>(meshIndices.size());
+    if (indexCount == 0) {
+        // The buffers stay for the next surface the chunk gets.
+        return;
+    }
+    if (VertexArrayObject == 0) {
+        createBuffers();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, VertexBufferObject);
+    glBufferData(GL_ARRAY_BUFFER, meshVertices.size() * sizeof(Vertex),
+                 meshVertices.data(), GL_STATIC_DRAW);
+
+    // The element buffer binding is part of the vertex array state.
+    glBindVertexArray(VertexArrayObject);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 meshIndices.size() * sizeof(unsigned int), meshIndices.data(),
+                 GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+void RenderableWaterMesh::createBuffers() {
+    glGenVertexArrays(1, &VertexArrayObject);
+    glGenBuffers(1, &VertexBufferObject);
+    glGenBuffers(1, &ElementBufferObject);
+
+    glBindVertexArray(VertexArrayObject);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VertexBufferObject);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBufferObject);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, texCoord));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+}
+
 void RenderableWaterMesh::render() const {
     if (indexCount > 0 and VertexArrayObject != 0) {
         glBindVertexArray(VertexArrayObject);
@@ -1,6 +1,6 @@
 #include "Renderer.hpp"
 #include "Entity.hpp"
-#include "WaterSystem.hpp"
+#include "BlockRegistry.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -23,6 +23,13 @@ constexpr glm::vec3 UNDERWATER_TINT{0.0f, 0.3f, 0.5f};
 constexpr float UNDERWATER_MIX_FACTOR{0.5f};
 constexpr float FADE_VALUE{0.2f};
 constexpr int LIGHT_VOLUME_TEXTURE_UNIT{15};
+constexpr int SURFACE_HEIGHTS_TEXTURE_UNIT{14};
+constexpr glm::vec3 SKY_COLOR{0.2f, 0.5f, 0.8f};
+/** Horizontal distances from the camera over which the horizon fades into
+ * the sky: from past the corners of the chunk window to the far edge of the
+ * horizon tiles. */
+constexpr float HORIZON_FOG_START{800.0f};
+constexpr float HORIZON_FOG_END{2048.0f};
 } // namespace
 
 void Renderer::setupDirectionalLightConfig() {
@@ -42,6 +49,7 @@ void Renderer::applyCubeShaderInitialConfig() {
     setupDirectionalLightConfig();
     setupWaterTintConfig();
     cubeShader->setInt("lightVolume", LIGHT_VOLUME_TEXTURE_UNIT);
+    cubeShader->setInt("surfaceHeights", SURFACE_HEIGHTS_TEXTURE_UNIT);
 }
 
 void Renderer::applyWaterShaderInitialConfig() {
@@ -51,6 +59,18 @@ void Renderer::applyWaterShaderInitialConfig() {
     waterShader->setVec3("directionalLight.ambient", LIGHT_AMBIENT);
     waterShader->setVec3("directionalLight.diffuse", LIGHT_DIFFUSE);
     waterShader->setInt("lightVolume", LIGHT_VOLUME_TEXTURE_UNIT);
+    waterShader->setInt("surfaceHeights", SURFACE_HEIGHTS_TEXTURE_UNIT);
+}
+
+void Renderer::applyHorizonShaderInitialConfig() {
+    horizonShader->use();
+    horizonShader->setVec3("directionalLight.direction",
+                           DIRECTIONAL_LIGHT_DIR);
+    horizonShader->setVec3("directionalLight.ambient", LIGHT_AMBIENT);
+    horizonShader->setVec3("directionalLight.diffuse", LIGHT_DIFFUSE);
+    horizonShader->setFloat("fogStart", HORIZON_FOG_START);
+    horizonShader->setFloat("fogEnd", HORIZON_FOG_END);
+    horizonShader->setVec3("fogColor", SKY_COLOR);
 }
 
 Renderer::Renderer(unsigned int width, unsigned int height)
@@ -60,6 +80,8 @@ Renderer::Renderer(unsigned int width, unsigned int height)
                                           "shaders/cube_shader.fs");
     waterShader = std::make_unique<Shader>("shaders/water_shader.vs",
                                            "shaders/water_shader.fs");
+    horizonShader = std::make_unique<Shader>("shaders/horizon_shader.vs",
+                                             "shaders/horizon_shader.fs");
     crosshairShader = std::make_unique<Shader>("shaders/crosshair_shader.vs",
                                                "shaders/crosshair_shader.fs");
     crosshair = std::make_unique<Crosshair>();
@@ -67,6 +89,7 @@ Renderer::Renderer(unsigned int width, unsigned int height)
         std::make_unique<StatusTextRenderer>(screenWidth, screenHeight);
     applyCubeShaderInitialConfig();
     applyWaterShaderInitialConfig();
+    applyHorizonShaderInitialConfig();
 }
 
 Renderer::~Renderer() { std::cout << "Renderer::Shutdown!" << std::endl; }
@@ -103,8 +126,15 @@ void Renderer::updateProjectionViewShaderParams(const Camera& camera) {
     waterShader->setMat4("projection", projection);
     waterShader->setMat4("view", cameraView);
 
+    const glm::mat4 horizonProjection = camera.getHorizonProjectionMatrix();
+    horizonShader->use();
+    horizonShader->setVec3("viewPosition", camera.getPosition());
+    horizonShader->setMat4("projection", horizonProjection);
+    horizonShader->setMat4("view", cameraView);
+
     glm::mat4 projView = projection * cameraView;
     frustum.update(projView);
+    horizonFrustum.update(horizonProjection * cameraView);
 }
 
 void Renderer::updateShaders(const Camera& camera) {
@@ -120,7 +150,7 @@ void Renderer::updateShaders(const Camera& camera) {
 
 void Renderer::renderOpaqueCubes(World& world) {
     for (const auto& [cubeType, cubeMaterial] : materials.get()) {
-        if (WaterSystem::isWater(cubeType)) {
+        if (not BlockRegistry::isSolid(cubeType)) {
             continue;
         }
         TextureManager::BindTextureToUnit(cubeMaterial.mainDiffuseTexturePath,
@@ -129,7 +159,7 @@ void Renderer::renderOpaqueCubes(World& world) {
                            cubeMaterial.mainDiffuseUnit);
         cubeShader->setBool("material.useSecondaryTexture",
                             cubeMaterial.useSecondaryTexture);
-        if (cubeType == CubeType::LOG) {
+        if (cubeMaterial.useSecondaryTexture) {
             TextureManager::BindTextureToUnit(
                 cubeMaterial.secondaryDiffuseTexturePath,
                 cubeMaterial.secondaryDiffuseUnit);
@@ -183,7 +213,11 @@ void Renderer::renderWater(World& world) {
 }
 
 void Renderer::renderCurrentWorldView(World& world) {
-    world.performFrustumCulling(frustum);
+    world.performFrustumCulling(frustum, horizonFrustum);
+    // The horizon lies wholly past the chunks, in a depth range of its own:
+    // drawn first, its depth is then cleared for the chunks to draw over.
+    world.renderHorizon(*horizonShader);
+    glClear(GL_DEPTH_BUFFER_BIT);
     cubeShader->use();
     renderOpaqueCubes(world);
     renderWater(world);
@@ -196,10 +230,14 @@ void Renderer::renderCrosshair() {
 }
 
 void Renderer::render(unsigned int fps, World& world) {
-    glClearColor(0.2f, 0.5f, 0.8f, 1.0f);
+    glClearColor(SKY_COLOR.r, SKY_COLOR.g, SKY_COLOR.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     renderCurrentWorldView(world);
     renderCrosshair();
     statusTextRenderer->renderStatus(fps, lastCameraPosition);
+    statusTextRenderer->renderMeshingStats(
+        world.getMeshingMode() == MeshingMode::GREEDY_QUADS ? "greedy quads"
+                                                            : "instanced cubes",
+        world.countRenderedTriangles());
 }
\ No newline at end of file
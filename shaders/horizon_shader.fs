@@ -0,0 +1,42 @@
+#version 460 core
+
+out vec4 FragColor;
+
+in vec3 fragPos;
+in vec3 normal;
+in vec3 color;
+
+struct DirectionalLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+};
+
+uniform vec3 viewPosition;
+uniform DirectionalLight directionalLight;
+
+// The loaded chunks are drawn inside this box instead.
+uniform vec3 chunkAreaMin;
+uniform vec3 chunkAreaMax;
+
+// Horizontal distances over which the terrain fades into the sky.
+uniform float fogStart;
+uniform float fogEnd;
+uniform vec3 fogColor;
+
+void main()
+{
+    if(all(greaterThanEqual(fragPos, chunkAreaMin)) &&
+       all(lessThan(fragPos, chunkAreaMax)))
+    {
+        discard;
+    }
+    const vec3 norm = normalize(normal);
+    const vec3 lightDirection = normalize(-directionalLight.direction);
+    const float diff = max(dot(norm, lightDirection), 0.0);
+    const vec3 lit = (directionalLight.ambient + directionalLight.diffuse * diff) * color;
+
+    const float distance = length(fragPos.xz - viewPosition.xz);
+    const float fog = clamp((distance - fogStart) / (fogEnd - fogStart), 0.0, 1.0);
+    FragColor = vec4(mix(lit, fogColor, fog), 1.0);
+}
@@ -0,0 +1,19 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec3 aColor;
+
+out vec3 fragPos;
+out vec3 normal;
+out vec3 color;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    fragPos = aPos;
+    normal = aNormal;
+    color = aColor;
+    gl_Position = projection * view * vec4(aPos, 1.0);
+}
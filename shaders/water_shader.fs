@@ -30,6 +30,10 @@ uniform bool shouldAnimateWater;
 uniform sampler3D lightVolume;
 uniform vec3 chunkOrigin;
 uniform float chunkSize;
+// Per column of the chunk: local y just above its highest solid block.
+uniform usampler2D surfaceHeights;
+// Blocks this far below the surface get only the cave ambient.
+const float SKY_FADE_DEPTH = 4.0;
 
 vec3 sampleCubeTexture(vec2 texCoord, vec3 normal)
 {
@@ -48,7 +52,10 @@ vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDirectio
     const vec3 ambient  = light.ambient  * sampleCubeTexture(texCoord, normal);
     const vec3 diffuse  = light.diffuse  * diff * sampleCubeTexture(texCoord, normal);
     const vec3 result = (ambient + diffuse);
-    const float skyFactor = clamp((fragPos.y - chunkOrigin.y) / (chunkSize / 4), 0.0, 1.0);
+    const ivec2 column = clamp(ivec2(floor(fragPos.xz - chunkOrigin.xz)), 0,
+                               int(chunkSize) - 1);
+    const float surfaceY = chunkOrigin.y + float(texelFetch(surfaceHeights, column, 0).r);
+    const float skyFactor = clamp(1.0 - (surfaceY - fragPos.y) / SKY_FADE_DEPTH, 0.0, 1.0);
     const vec3 caveAmbient = vec3(0.05);
     return mix(caveAmbient, result, skyFactor);
 }
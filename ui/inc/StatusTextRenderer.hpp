@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <glm/glm.hpp>
@@ -13,6 +14,8 @@ class StatusTextRenderer {
     StatusTextRenderer& operator=(const StatusTextRenderer&) = delete;
     StatusTextRenderer& operator=(StatusTextRenderer&&) = delete;
     void renderStatus(unsigned int fps, const glm::vec3& cameraPos);
+    void renderMeshingStats(const std::string& modeName,
+                            std::size_t triangleCount);
 
    private:
     void renderCameraPosition(const glm::vec3& cameraPos);
@@ -28,4 +31,7 @@ class StatusTextRenderer {
     float fpsTextPosX{};
     float fpsTextPosY{};
     float fpsTextScale{};
+
+    float meshingTextPosX{};
+    float meshingTextPosY{};
 };
\ No newline at end of file
@@ -9,7 +9,9 @@ StatusTextRenderer::StatusTextRenderer(float screenWidth, float screenHeight)
       cameraTextScale(0.7f),
       fpsTextPosX(25.0f),
       fpsTextPosY(25.0f),
-      fpsTextScale(1.0f) {
+      fpsTextScale(1.0f),
+      meshingTextPosX(25.0f),
+      meshingTextPosY(310.0f) {
     fontManager = std::make_unique<FontManager>(screenWidth, screenHeight);
 }
 
@@ -50,3 +52,14 @@ void StatusTextRenderer::renderStatus(unsigned int fps,
     renderCameraPosition(cameraPos);
     renderFpsCount(fps);
 }
+
+void StatusTextRenderer::renderMeshingStats(const std::string& modeName,
+                                            std::size_t triangleCount) {
+    const glm::vec3 textColor(1.0f, 0.9f, 0.5f);
+    fontManager->renderText("Meshing: " + modeName, meshingTextPosX,
+                            meshingTextPosY, cameraTextScale, textColor);
+    fontManager->renderText("Triangles: " + std::to_string(triangleCount),
+                            meshingTextPosX,
+                            meshingTextPosY + cameraTextLineSpacing,
+                            cameraTextScale, textColor);
+}
@@ -1,35 +1,31 @@
 #pragma once
 #include "ChunkCoord.hpp"
+#include "ChunkHalo.hpp"
+#include "ChunkWindowIndex.hpp"
 #include "RenderableChunk.hpp"
-#include "VoxelTypes.hpp"
-#include <glm/vec3.hpp>
 
 class NeighborGatherer {
    public:
-    NeighborGatherer(int size);
+    NeighborGatherer() = default;
     ~NeighborGatherer() = default;
     NeighborGatherer(const NeighborGatherer&) = delete;
     NeighborGatherer& operator=(const NeighborGatherer&) = delete;
     NeighborGatherer(NeighborGatherer&&) = delete;
     NeighborGatherer& operator=(NeighborGatherer&&) = delete;
 
-    VoxelTypes::NeighborVoxelsMap gatherNeighborsForCoord(
-        const ChunkCoord& center,
-        const std::function<const RenderableChunk*(const ChunkCoord&)>&
-            getChunk);
+    /** Fills out with the cells bordering center on every side, leaving
+     * air where no neighbor is loaded. */
+    void gatherHaloForCoord(const ChunkCoord& center,
+                            const ChunkWindowIndex& chunks, ChunkHalo& out);
 
    private:
-    void gatherEastWestFace(const RenderableChunk* neighbor,
-                            VoxelTypes::NeighborVoxelsMap& out);
-    void gatherNorthSouthFace(const RenderableChunk* neighbor,
-                              VoxelTypes::NeighborVoxelsMap& out);
-    void gatherDiagonalXZ(const RenderableChunk* neighbor,
-                          VoxelTypes::NeighborVoxelsMap& out);
-    void gatherNeighborFaces(const RenderableChunk* neighbor,
-                             VoxelTypes::NeighborVoxelsMap& out);
-    int chunkSize{0};
-    int offsetX{0};
-    int offsetZ{0};
-    int paddedX{0};
-    int paddedZ{0};
-};
\ No newline at end of file
+    /** Copies the columns of the neighbor at (offsetX, offsetZ) that touch
+     * the center chunk, whole columns at a time. */
+    void gatherNeighborColumns(const RenderableChunk* neighbor, int offsetX,
+                               int offsetZ, ChunkHalo& out);
+    /** Copies the cells of the neighbor below or above, at horizontal
+     * offset (offsetX, offsetZ), that touch the center chunk. */
+    void gatherNeighborLayer(const RenderableChunk* neighbor, int offsetX,
+                             int offsetZ, ChunkHalo::Layer layer,
+                             ChunkHalo& out);
+};
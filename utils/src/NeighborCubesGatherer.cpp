@@ -1,77 +1,80 @@
 #include "NeighborCubesGatherer.hpp"
+#include <algorithm>
 
-NeighborGatherer::NeighborGatherer(int size) : chunkSize{size} {}
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int PADDED_SIZE{ChunkGeometry::PADDED_CHUNK_SIZE};
 
-void NeighborGatherer::gatherEastWestFace(const RenderableChunk* neighbor,
-                                          VoxelTypes::NeighborVoxelsMap& out) {
-    int localX = (offsetX < 0 ? chunkSize - 1 : 0);
-    for (int y = 0; y < chunkSize; ++y) {
-        for (int z = 0; z < chunkSize; ++z) {
-            if (neighbor->isValidCubeAt({localX, y, z})) {
-                const glm::ivec3 paddedPos{paddedX, y + 1, z + 1};
-                out[paddedPos] = neighbor->getCubeType({localX, y, z});
-            }
-        }
+/** Along one axis, the local indices in a neighbor that touch the center
+ * chunk, and the shift from those to padded indices of the center. */
+struct BorderSpan {
+    int first{0};
+    int last{0};
+    int toPadded{0};
+};
+
+BorderSpan borderSpan(int offset) {
+    if (offset == 0) {
+        return {0, CHUNK_SIZE - 1, 1};
     }
+    const int local{offset < 0 ? CHUNK_SIZE - 1 : 0};
+    const int padded{offset < 0 ? 0 : PADDED_SIZE - 1};
+    return {local, local, padded - local};
 }
+} // namespace
 
-void NeighborGatherer::gatherNorthSouthFace(
-    const RenderableChunk* neighbor, VoxelTypes::NeighborVoxelsMap& out) {
-    int localZ = (offsetZ < 0 ? chunkSize - 1 : 0);
-    for (int x = 0; x < chunkSize; ++x) {
-        for (int y = 0; y < chunkSize; ++y) {
-            if (neighbor->isValidCubeAt({x, y, localZ})) {
-                const glm::ivec3 paddedPos{x + 1, y + 1, paddedZ};
-                out[paddedPos] = neighbor->getCubeType({x, y, localZ});
+void NeighborGatherer::gatherNeighborColumns(const RenderableChunk* neighbor,
+                                             int offsetX, int offsetZ,
+                                             ChunkHalo& out) {
+    const auto spanX = borderSpan(offsetX);
+    const auto spanZ = borderSpan(offsetZ);
+    for (int x = spanX.first; x <= spanX.last; ++x) {
+        for (int z = spanZ.first; z <= spanZ.last; ++z) {
+            auto* column =
+                out.column(x + spanX.toPadded, z + spanZ.toPadded);
+            if (neighbor) {
+                neighbor->readColumn(x, z, column);
+            } else {
+                std::fill_n(column, CHUNK_SIZE, CubeType::NONE);
             }
         }
     }
 }
 
-void NeighborGatherer::gatherDiagonalXZ(const RenderableChunk* neighbor,
-                                        VoxelTypes::NeighborVoxelsMap& out) {
-    int localX = (offsetX < 0 ? chunkSize - 1 : 0);
-    int localZ = (offsetZ < 0 ? chunkSize - 1 : 0);
-    for (int y = 0; y < chunkSize; ++y) {
-        if (neighbor->isValidCubeAt({localX, y, localZ})) {
-            const glm::ivec3 paddedPos{paddedX, y + 1, paddedZ};
-            out[paddedPos] = neighbor->getCubeType({localX, y, localZ});
+void NeighborGatherer::gatherNeighborLayer(const RenderableChunk* neighbor,
+                                           int offsetX, int offsetZ,
+                                           ChunkHalo::Layer layer,
+                                           ChunkHalo& out) {
+    const int localY{layer == ChunkHalo::BELOW ? CHUNK_SIZE - 1 : 0};
+    const auto spanX = borderSpan(offsetX);
+    const auto spanZ = borderSpan(offsetZ);
+    auto* cells = out.layer(layer);
+    for (int x = spanX.first; x <= spanX.last; ++x) {
+        for (int z = spanZ.first; z <= spanZ.last; ++z) {
+            cells[ChunkHalo::layerIndexOf(x + spanX.toPadded,
+                                          z + spanZ.toPadded)] =
+                neighbor ? neighbor->getCubeType({x, localY, z})
+                         : CubeType::NONE;
         }
     }
 }
 
-void NeighborGatherer::gatherNeighborFaces(const RenderableChunk* neighbor,
-                                           VoxelTypes::NeighborVoxelsMap& out) {
-    if (not neighbor) {
-        return;
-    } else if (offsetX != 0 && offsetZ == 0) {
-        paddedX = (offsetX < 0 ? 0 : chunkSize + 1);
-        gatherEastWestFace(neighbor, out);
-    } else if (offsetX == 0 && offsetZ != 0) {
-        paddedZ = (offsetZ < 0 ? 0 : chunkSize + 1);
-        gatherNorthSouthFace(neighbor, out);
-    } else {
-        paddedX = (offsetX < 0 ? 0 : chunkSize + 1);
-        paddedZ = (offsetZ < 0 ? 0 : chunkSize + 1);
-        gatherDiagonalXZ(neighbor, out);
-    }
-}
-
-VoxelTypes::NeighborVoxelsMap NeighborGatherer::gatherNeighborsForCoord(
-    const ChunkCoord& center,
-    const std::function<const RenderableChunk*(const ChunkCoord&)>& getChunk) {
-    VoxelTypes::NeighborVoxelsMap result;
-
-    for (offsetX = -1; offsetX <= 1; ++offsetX) {
-        for (offsetZ = -1; offsetZ <= 1; ++offsetZ) {
-            if (offsetX == 0 && offsetZ == 0) {
-                continue;
+void NeighborGatherer::gatherHaloForCoord(const ChunkCoord& center,
+                                          const ChunkWindowIndex& chunks,
+                                          ChunkHalo& out) {
+    for (int offsetX = -1; offsetX <= 1; ++offsetX) {
+        for (int offsetZ = -1; offsetZ <= 1; ++offsetZ) {
+            const auto neighborAt = [&](int offsetY) {
+                return chunks.find({center.x + offsetX, center.y + offsetY,
+                                    center.z + offsetZ});
+            };
+            gatherNeighborLayer(neighborAt(-1), offsetX, offsetZ,
+                                ChunkHalo::BELOW, out);
+            gatherNeighborLayer(neighborAt(1), offsetX, offsetZ,
+                                ChunkHalo::ABOVE, out);
+            if (offsetX != 0 or offsetZ != 0) {
+                gatherNeighborColumns(neighborAt(0), offsetX, offsetZ, out);
             }
-
-            ChunkCoord neighborCoord{center.x + offsetX, center.z + offsetZ};
-            const RenderableChunk* neighbor = getChunk(neighborCoord);
-            gatherNeighborFaces(neighbor, result);
         }
     }
-    return result;
 }
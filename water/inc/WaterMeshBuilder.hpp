@@ -1,57 +1,48 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <glm/vec3.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include "Cube.hpp"
+#include "BlockStateTable.hpp"
+#include "CpuWaterMesh.hpp"
 #include "VoxelTypes.hpp"
 #include "VertexData.hpp"
 
+/** Water surfaces of a chunk, as a single mesh. Each layer of water cells is
+ * cut into maximal rectangles of one surface height: grown along x, then
+ * along z while every cell of the next row matches. A calm sea then takes a
+ * handful of quads per chunk rather than one per block. Texture coordinates
+ * span each rectangle in blocks, so the water texture still repeats once
+ * per block. The scratch buffers are kept from one build to the next; use
+ * one builder per thread. */
 class WaterMeshBuilder {
    public:
-    struct WaterSurface {
-        std::vector<Vertex> vertices{};
-        std::vector<unsigned int> indices{};
-        CubeType waterType;
-        glm::vec3 center{};
-    };
-
-    std::vector<WaterSurface> buildWaterSurfaces(
-        const VoxelTypes::VoxelGrid3D& voxelGrid, float chunkWorldX,
-        float chunkWorldZ);
+    /** Flowing water sits at the height of its flow level, read from
+     * blockStates. Empty when the chunk holds no water. */
+    CpuWaterMesh build(const VoxelTypes::VoxelGrid3D& voxelGrid,
+                       const BlockStateTable& blockStates,
+                       const glm::vec3& chunkOrigin);
 
    private:
-    std::vector<std::vector<std::vector<bool>>> processed;
-
-    WaterSurface buildConnectedSurface(const VoxelTypes::VoxelGrid3D& voxelGrid,
-                                       const glm::ivec3& position,
-                                       float chunkWorldX, float chunkWorldZ);
-
-    void initializeProcessedGrid(int chunkSize);
-
-    std::vector<WaterSurface> collectWaterSurfaces(
-        const VoxelTypes::VoxelGrid3D& voxelGrid, int chunkSize,
-        float chunkWorldX, float chunkWorldZ);
-
-    bool isValidWaterPosition(const VoxelTypes::VoxelGrid3D& voxelGrid,
-                              const glm::ivec3& position) const;
-
-    std::vector<glm::ivec3> createWaterSurface(
-        const VoxelTypes::VoxelGrid3D& voxelGrid, const glm::ivec3& position,
-        CubeType waterType);
-
-    void generateUnifiedMesh(const std::vector<glm::ivec3>& surfaceBlocks,
-                             float chunkWorldX, float chunkWorldZ,
-                             WaterSurface& surface);
-
-    glm::vec3 calculateSurfaceCenter(
-        const std::vector<glm::ivec3>& surfaceBlocks, float chunkWorldX,
-        float chunkWorldZ) const;
-
-    glm::vec3 calculateWorldPosition(const glm::ivec3& block, float chunkWorldX,
-                                     float chunkWorldZ) const;
-
-    std::vector<Vertex> createWaterQuadVertices(
-        const glm::vec3& position) const;
-
-    void addWaterQuad(const glm::vec3& position, WaterSurface& surface);
+    static constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    static_assert(CHUNK_SIZE == 64, "a column must fill one 64-bit mask");
+    using ColumnMask = std::uint64_t;
+
+    /** Bit y of each (x, z) column set for water, and the union of all of
+     * them. */
+    std::uint64_t collectWaterColumns(const VoxelTypes::VoxelGrid3D& voxelGrid);
+    void fillLayer(const VoxelTypes::VoxelGrid3D& voxelGrid,
+                   const BlockStateTable& blockStates, int y);
+    /** Cuts the cells of the layer into rectangles, clearing the cells it
+     * uses. */
+    void mergeLayer(int y, const glm::vec3& chunkOrigin);
+    void appendQuad(const glm::vec3& corner, int width, int depth);
+
+    /** Indexed z * CHUNK_SIZE + x, as are the cells. */
+    std::array<ColumnMask, CHUNK_SIZE * CHUNK_SIZE> waterColumns{};
+    /** Surface height of each water cell of one layer above the bottom of
+     * its block, 0 where there is no water. */
+    std::array<float, CHUNK_SIZE * CHUNK_SIZE> cells{};
+    std::vector<Vertex> vertices{};
+    std::vector<unsigned int> indices{};
 };
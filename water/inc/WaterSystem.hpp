@@ -1,25 +1,31 @@
 #pragma once
+#include <algorithm>
+#include "BlockRegistry.hpp"
 #include "Cube.hpp"
 #include <glm/vec3.hpp>
 
 namespace WaterSystem {
 
-inline bool isWater(CubeType type) {
-    return type == CubeType::WATER_SOURCE or type == CubeType::WATER_FLOWING;
-}
+inline bool isWater(CubeType type) { return BlockRegistry::isFluid(type); }
 
 inline bool isWaterSource(CubeType type) {
     return type == CubeType::WATER_SOURCE;
 }
 
+/** Flow levels of flowing water run from 1, the thinnest, up to this one
+ * next to its source. Level 0 keeps the block's registry height. */
+constexpr BlockState MAX_FLOW_LEVEL{7};
+
 inline float getWaterHeight(CubeType type) {
-    if (type == CubeType::WATER_SOURCE) {
-        return 1.0f;
-    }
-    if (type == CubeType::WATER_FLOWING) {
-        return 0.8f;
+    return BlockRegistry::getFluidHeight(type);
+}
+
+inline float getWaterHeight(const Voxel& voxel) {
+    if (voxel.type == CubeType::WATER_FLOWING and voxel.state != 0) {
+        return static_cast<float>(std::min(voxel.state, MAX_FLOW_LEVEL)) /
+               (MAX_FLOW_LEVEL + 1);
     }
-    return 0.0f;
+    return getWaterHeight(voxel.type);
 }
 
 inline bool shouldRenderWaterFace(CubeType current, CubeType neighbor) {
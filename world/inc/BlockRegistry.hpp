@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "Cube.hpp"
+
+/** Behaviour of every block type, declared once as a row per CubeType and
+ * expanded at compile time into one small table per property. Lookups are
+ * a single load indexed by the block id, and adding a block type is a new
+ * row here plus its Material. */
+namespace BlockRegistry {
+enum class CollisionShape : std::uint8_t { NONE, FULL_CUBE };
+
+struct BlockProperties {
+    CubeType type{CubeType::NONE};
+    /** Meshed as an instanced cube. */
+    bool solid{false};
+    /** Hides the faces of the blocks next to it. */
+    bool opaque{false};
+    bool fluid{false};
+    /** Light passes through and keeps spreading. */
+    bool transmitsLight{false};
+    /** Light level the block emits, 0 for none. */
+    float emission{0.0f};
+    /** Surface height of a fluid block, in blocks. */
+    float fluidHeight{0.0f};
+    CollisionShape collision{CollisionShape::NONE};
+    /** Carries a BlockState next to its id. */
+    bool stateful{false};
+};
+
+namespace detail {
+constexpr BlockProperties air() {
+    return {CubeType::NONE, false, false, false, true, 0.0f, 0.0f,
+            CollisionShape::NONE, false};
+}
+constexpr BlockProperties cube(CubeType type, float emission = 0.0f) {
+    return {type, true, true, false, false, emission, 0.0f,
+            CollisionShape::FULL_CUBE, false};
+}
+constexpr BlockProperties water(CubeType type, float surfaceHeight,
+                                bool stateful = false) {
+    return {type, false, false, true, false, 0.0f, surfaceHeight,
+            CollisionShape::NONE, stateful};
+}
+
+/** One row per CubeType, in declaration order. */
+constexpr std::array BLOCKS{
+    air(),
+    cube(CubeType::SAND),
+    cube(CubeType::DIRT),
+    cube(CubeType::GRASS),
+    water(CubeType::WATER_SOURCE, 1.0f),
+    water(CubeType::WATER_FLOWING, 0.8f, true),
+    cube(CubeType::LOG),
+    cube(CubeType::LEAVES),
+    cube(CubeType::TORCH, 1.0f),
+};
+
+constexpr bool isIndexedById() {
+    for (std::size_t id = 0; id < BLOCKS.size(); ++id) {
+        if (static_cast<std::size_t>(BLOCKS[id].type) != id) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isIndexedById(), "block rows must follow CubeType order");
+
+/** Chunk occupancy masks stand in for collision, so the two must agree. */
+constexpr bool collidesExactlyWhenSolid() {
+    for (const auto& block : BLOCKS) {
+        if (block.solid != (block.collision == CollisionShape::FULL_CUBE)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(collidesExactlyWhenSolid(),
+              "solid blocks and full-cube colliders must coincide");
+
+template <auto Member>
+constexpr auto makeTable() {
+    std::array<std::remove_cvref_t<decltype(BLOCKS[0].*Member)>,
+               BLOCKS.size()>
+        table{};
+    for (std::size_t id = 0; id < BLOCKS.size(); ++id) {
+        table[id] = BLOCKS[id].*Member;
+    }
+    return table;
+}
+
+constexpr auto SOLID{makeTable<&BlockProperties::solid>()};
+constexpr auto OPAQUE{makeTable<&BlockProperties::opaque>()};
+constexpr auto FLUID{makeTable<&BlockProperties::fluid>()};
+constexpr auto TRANSMITS_LIGHT{makeTable<&BlockProperties::transmitsLight>()};
+constexpr auto EMISSION{makeTable<&BlockProperties::emission>()};
+constexpr auto FLUID_HEIGHT{makeTable<&BlockProperties::fluidHeight>()};
+constexpr auto COLLISION{makeTable<&BlockProperties::collision>()};
+constexpr auto STATEFUL{makeTable<&BlockProperties::stateful>()};
+
+constexpr std::size_t idOf(CubeType type) {
+    return static_cast<std::size_t>(type);
+}
+} // namespace detail
+
+constexpr std::size_t BLOCK_TYPE_COUNT{detail::BLOCKS.size()};
+
+constexpr const BlockProperties& get(CubeType type) {
+    return detail::BLOCKS[detail::idOf(type)];
+}
+constexpr bool isSolid(CubeType type) {
+    return detail::SOLID[detail::idOf(type)];
+}
+constexpr bool isOpaque(CubeType type) {
+    return detail::OPAQUE[detail::idOf(type)];
+}
+constexpr bool isFluid(CubeType type) {
+    return detail::FLUID[detail::idOf(type)];
+}
+constexpr bool transmitsLight(CubeType type) {
+    return detail::TRANSMITS_LIGHT[detail::idOf(type)];
+}
+constexpr float getEmission(CubeType type) {
+    return detail::EMISSION[detail::idOf(type)];
+}
+constexpr bool isEmissive(CubeType type) { return getEmission(type) > 0.0f; }
+constexpr float getFluidHeight(CubeType type) {
+    return detail::FLUID_HEIGHT[detail::idOf(type)];
+}
+constexpr CollisionShape getCollisionShape(CubeType type) {
+    return detail::COLLISION[detail::idOf(type)];
+}
+constexpr bool isStateful(CubeType type) {
+    return detail::STATEFUL[detail::idOf(type)];
+}
+} // namespace BlockRegistry
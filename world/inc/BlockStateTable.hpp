@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/vec3.hpp>
+#include "Cube.hpp"
+#include "VoxelTypes.hpp"
+
+/** Sparse BlockState storage for one chunk, split into the same sections as
+ * its voxel grid. Only the cells holding a non-default state are stored, as
+ * entries sorted by cell within their section; a chunk without stateful
+ * blocks keeps no sections at all, and a section without states keeps no
+ * entries. */
+class BlockStateTable {
+   public:
+    using VoxelGrid3D = VoxelTypes::VoxelGrid3D;
+
+    /** State of the cell at localPos, 0 when none is stored. */
+    BlockState at(const glm::ivec3& localPos) const;
+    /** Stores state for the cell at localPos; 0 erases it. */
+    void set(const glm::ivec3& localPos, BlockState state);
+    inline void erase(const glm::ivec3& localPos) { set(localPos, 0); }
+
+    inline bool empty() const { return stateCount == 0; }
+    inline std::size_t size() const { return stateCount; }
+    std::size_t getResidentBytes() const;
+
+   private:
+    struct Entry {
+        std::uint16_t cell{0};
+        BlockState state{0};
+    };
+    static constexpr int SECTION_SHIFT{VoxelGrid3D::SECTION_SHIFT};
+    static constexpr int SECTION_MASK{VoxelGrid3D::SECTION_MASK};
+    static constexpr int SECTIONS_PER_AXIS{VoxelGrid3D::SECTIONS_PER_AXIS};
+    static constexpr std::size_t SECTION_COUNT{
+        static_cast<std::size_t>(SECTIONS_PER_AXIS) * SECTIONS_PER_AXIS *
+        SECTIONS_PER_AXIS};
+
+    static std::size_t sectionIndexOf(const glm::ivec3& localPos);
+    static std::uint16_t cellIndexOf(const glm::ivec3& localPos);
+
+    /** Empty while the chunk holds no state, SECTION_COUNT lists after. */
+    std::vector<std::vector<Entry>> sections{};
+    std::size_t stateCount{0};
+};
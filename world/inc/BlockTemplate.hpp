@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/vec3.hpp>
+#include "Cube.hpp"
+
+/** A stored box of blocks for World::pasteTemplate. Air cells leave the
+ * world as it is, so a stamp does not have to be box shaped. */
+class BlockTemplate {
+   public:
+    explicit BlockTemplate(const glm::ivec3& templateSize)
+        : size{templateSize},
+          blocks(static_cast<std::size_t>(size.x) * size.y * size.z,
+                 CubeType::NONE) {}
+
+    inline const glm::ivec3& getSize() const { return size; }
+    inline CubeType at(const glm::ivec3& pos) const {
+        return blocks[indexOf(pos)];
+    }
+    inline void set(const glm::ivec3& pos, CubeType type) {
+        blocks[indexOf(pos)] = type;
+    }
+
+   private:
+    inline std::size_t indexOf(const glm::ivec3& pos) const {
+        return (static_cast<std::size_t>(pos.x) * size.z + pos.z) * size.y +
+               pos.y;
+    }
+
+    glm::ivec3 size{};
+    std::vector<CubeType> blocks{};
+};
@@ -1,37 +1,56 @@
 #pragma once
 #include "glm/glm.hpp"
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include "ChunkGeometry.hpp"
 
 class CpuChunk;
-class RenderableChunk;
-class ChunkUpdater;
 
 constexpr std::array<glm::ivec3, 6> NEIGHBOR_OFFSETS = {
     glm::ivec3(1, 0, 0),  glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0),
     glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1),  glm::ivec3(0, 0, -1)};
 
+/** A chunk in the world: a column position (x, z) and its layer y in the
+ * vertical stack, all in units of CHUNK_SIZE. */
 struct ChunkCoord {
     int x{0};
+    int y{0};
     int z{0};
     bool operator==(const ChunkCoord& other) const {
-        return x == other.x and z == other.z;
+        return x == other.x and y == other.y and z == other.z;
     }
 };
 
 struct ChunkWindow {
     int minX{0};
     int maxX{0};
+    int minY{0};
+    int maxY{0};
     int minZ{0};
     int maxZ{0};
 };
 
-struct PositionXYHash {
+/** SplitMix64 finalizer over x and z packed into one word, with the layer
+ * folded in through an odd multiplier. Every input bit reaches every output
+ * bit, so neighboring chunks spread over the whole table instead of
+ * clustering like a shift-xor of the ints. */
+inline std::uint64_t hashChunkCoord(const ChunkCoord& coord) {
+    const auto high =
+        static_cast<std::uint64_t>(static_cast<std::uint32_t>(coord.x));
+    const auto low = static_cast<std::uint32_t>(coord.z);
+    const auto layer = static_cast<std::uint32_t>(coord.y);
+    auto mixed = ((high << 32) | low) + 0x9e3779b97f4a7c15ull +
+                 layer * 0xd6e8feb86659fd93ull;
+    mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+    return mixed ^ (mixed >> 31);
+}
+
+struct ChunkCoordHash {
     std::size_t operator()(const ChunkCoord& coord) const {
-        std::size_t h1 = std::hash<int>{}(coord.x);
-        std::size_t h2 = std::hash<int>{}(coord.z);
-        return (h1 << 1) ^ h2;
+        return static_cast<std::size_t>(hashChunkCoord(coord));
     }
 };
 
@@ -44,18 +63,25 @@ struct PositionXYZHash {
     }
 };
 
-bool isPositionWithinBounds(const glm::ivec3& pos, int boundary);
+inline bool isPositionWithinBounds(const glm::ivec3& pos, int boundary) {
+    return (pos.x >= 0 and pos.x < boundary and pos.y >= 0 and
+            pos.y < boundary and pos.z >= 0 and pos.z < boundary);
+}
 bool isChunkWithinWindow(const ChunkCoord& coord, const ChunkWindow& window);
-ChunkCoord fromWorldPosition(const glm::ivec3& position);
-glm::ivec3 toLocalPosition(const glm::ivec3& position);
+
+inline ChunkCoord fromWorldPosition(const glm::ivec3& position) {
+    return {ChunkGeometry::toChunkIndex(position.x),
+            ChunkGeometry::toChunkIndex(position.y),
+            ChunkGeometry::toChunkIndex(position.z)};
+}
+
+inline glm::ivec3 toLocalPosition(const glm::ivec3& position) {
+    return {ChunkGeometry::toLocalIndex(position.x),
+            ChunkGeometry::toLocalIndex(position.y),
+            ChunkGeometry::toLocalIndex(position.z)};
+}
 
 namespace Coord {
 using CpuChunksMap =
-    std::unordered_map<ChunkCoord, std::unique_ptr<CpuChunk>, PositionXYHash>;
-using RenderableChunksMap =
-    std::unordered_map<ChunkCoord, std::unique_ptr<RenderableChunk>,
-                       PositionXYHash>;
-using ChunkUpdatersMap =
-    std::unordered_map<ChunkCoord, std::unique_ptr<ChunkUpdater>,
-                       PositionXYHash>;
+    std::unordered_map<ChunkCoord, std::unique_ptr<CpuChunk>, ChunkCoordHash>;
 } // namespace Coord
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ChunkGeometry.hpp"
+#include "ChunkHalo.hpp"
+#include "VoxelTypes.hpp"
+
+/** Bitmask meshing kernel. Packs the solid and opaque cells of a chunk into
+ * one 64-bit mask per (x, z) column, bit y for local height y, and derives
+ * for each of the six face directions the solid cells whose neighbor that
+ * way is not opaque: a shift of the column itself for up and down, an AND
+ * with the next column for the four sides. Faces on the chunk border are
+ * tested against the neighbor cells of a ChunkHalo, and count as visible
+ * where no neighbor is loaded. Every step is a plain loop over arrays of
+ * words, which the compiler vectorizes. */
+class ChunkFaceMasks {
+   public:
+    using ColumnMask = std::uint64_t;
+    static constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    static_assert(CHUNK_SIZE == 64, "a column must fill one 64-bit mask");
+    /** In the order of NEIGHBOR_OFFSETS. */
+    enum Face : int { POS_X, NEG_X, POS_Y, NEG_Y, POS_Z, NEG_Z, FACE_COUNT };
+    /** One bit per Face. */
+    using FaceSet = std::uint8_t;
+
+    /** Recomputes every mask from grid, with every border face visible. */
+    void build(const VoxelTypes::VoxelGrid3D& grid);
+    /** Recomputes every mask from grid, hiding the border faces covered by
+     * an opaque cell of halo, except on the sides in openFaces. */
+    void build(const VoxelTypes::VoxelGrid3D& grid, const ChunkHalo& halo,
+               FaceSet openFaces = 0);
+    /** As above, but only for the columns crossing the sections set in
+     * sections, one bit per VoxelGrid3D section; the other columns keep
+     * whatever they held. */
+    void build(const VoxelTypes::VoxelGrid3D& grid, const ChunkHalo& halo,
+               FaceSet openFaces, std::uint64_t sections);
+
+    inline ColumnMask solidAt(int localX, int localZ) const {
+        return solid[indexOf(localX, localZ)];
+    }
+    /** Solid cells of the column with a visible face towards face. */
+    inline ColumnMask facesAt(Face face, int localX, int localZ) const {
+        return faces[face][indexOf(localX, localZ)];
+    }
+    /** Solid cells of the column with at least one visible face. */
+    inline ColumnMask exposedAt(int localX, int localZ) const {
+        return exposed[indexOf(localX, localZ)];
+    }
+
+   private:
+    static constexpr std::size_t COLUMN_COUNT{
+        static_cast<std::size_t>(CHUNK_SIZE) * CHUNK_SIZE};
+    using ColumnMasks = std::array<ColumnMask, COLUMN_COUNT>;
+
+    /** x-major like the voxel grid, so the columns of one x are adjacent. */
+    static constexpr std::size_t indexOf(int localX, int localZ) {
+        return static_cast<std::size_t>(localX) * CHUNK_SIZE + localZ;
+    }
+
+    /** Columns [beginX, endX) x [beginZ, endZ). */
+    struct ColumnRange {
+        int beginX{0};
+        int endX{CHUNK_SIZE};
+        int beginZ{0};
+        int endZ{CHUNK_SIZE};
+    };
+
+    void buildColumnMasks(const VoxelTypes::VoxelGrid3D& grid,
+                          const ColumnRange& range);
+    void buildBorderMasks(const ChunkHalo& halo, FaceSet openFaces);
+    void buildFaceMasks(const ColumnRange& range);
+
+    /** Opaque cells just outside each face of the chunk. For the four sides,
+     * one mask over y per border column, indexed by the coordinate along
+     * the face; for up and down, one mask over z per x. */
+    std::array<std::array<ColumnMask, CHUNK_SIZE>, FACE_COUNT> border{};
+    ColumnMasks solid{};
+    ColumnMasks opaque{};
+    std::array<ColumnMasks, FACE_COUNT> faces{};
+    ColumnMasks exposed{};
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <glm/vec3.hpp>
+
+/** Chunk dimensions, fixed at compile time. Every chunk is a CHUNK_SIZE^3
+ * cube of voxels, so converting world coordinates to chunk and local ones is
+ * a shift and a mask, and loops over a chunk have constant trip counts. */
+namespace ChunkGeometry {
+constexpr int CHUNK_SHIFT{6};
+constexpr int CHUNK_SIZE{1 << CHUNK_SHIFT};
+constexpr int CHUNK_MASK{CHUNK_SIZE - 1};
+constexpr int CHUNK_VOLUME{CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE};
+/** A chunk plus a one-voxel halo of its neighbors on every side. */
+constexpr int PADDED_CHUNK_SIZE{CHUNK_SIZE + 2};
+/** Chunks are stacked this many deep, from world y = 0 upwards. */
+constexpr int WORLD_HEIGHT_IN_CHUNKS{4};
+
+static_assert((CHUNK_SIZE & CHUNK_MASK) == 0,
+              "chunk size must be a power of two");
+
+/** Index of the chunk holding a world voxel coordinate. The arithmetic
+ * shift rounds towards negative infinity, so -1 maps to chunk -1. */
+constexpr int toChunkIndex(int worldCoord) { return worldCoord >> CHUNK_SHIFT; }
+
+/** Position of a world voxel coordinate inside its chunk, in [0, size). */
+constexpr int toLocalIndex(int worldCoord) { return worldCoord & CHUNK_MASK; }
+
+/** World coordinate of the first voxel of a chunk. */
+constexpr int toWorldOrigin(int chunkIndex) { return chunkIndex * CHUNK_SIZE; }
+
+inline bool isWithinChunk(const glm::ivec3& localPos) {
+    return static_cast<unsigned>(localPos.x) < CHUNK_SIZE and
+           static_cast<unsigned>(localPos.y) < CHUNK_SIZE and
+           static_cast<unsigned>(localPos.z) < CHUNK_SIZE;
+}
+} // namespace ChunkGeometry
@@ -2,8 +2,9 @@
 #include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
 #include "Cube.hpp"
+#include "ChunkHeightmap.hpp"
+#include "ChunkMesh.hpp"
 #include "Shader.hpp"
 
 /** Holds only GL state – all uploads & draw‑calls happen here. */
@@ -20,24 +21,68 @@ class ChunkGraphics {
     void initializeGL(unsigned sharedVBO, unsigned sharedCubeEBO,
                       unsigned sharedWaterEBO, int volumeDimension);
 
-    void updateInstanceData(
-        const std::unordered_map<CubeType, std::vector<glm::mat4>>& matrices);
+    /** Writes the instances of the sections the mesh covers into their
+     * slots, in place while they fit; only the slot layout is kept. */
+    void updateInstanceData(const ChunkMesh& mesh);
+    /** Uploads the merged face quads into this chunk's own buffers. */
+    void updateQuadData(const ChunkMesh& mesh);
     void updateLightVolume(const std::vector<float>& volume,
                            int volumeDimension);
+    /** Back to no light anywhere in the chunk. */
+    void clearLightVolume();
+    void updateSurfaceHeights(const ChunkHeightmap& heightmap);
+    /** Binds the light volume and surface heights the shaders sample. */
+    void bindTextures() const;
 
     void renderByType(CubeType type) const;
+    /** Triangles drawn for all block types, in either meshing mode. */
+    inline std::size_t getTriangleCount() const {
+        return instanceTriangleCount + quadTriangleCount;
+    }
 
    private:
+    /** GPU instances of one block type. Each section owns a fixed range of
+     * slots with room to grow, so remeshing a section rewrites its range in
+     * place; the ranges are drawn with one indirect multi-draw. */
+    struct InstanceSlots {
+        GLuint buffer{0};
+        GLuint drawCommands{0};
+        ChunkMesh::SectionCounts first{};
+        ChunkMesh::SectionCounts count{};
+        ChunkMesh::SectionCounts capacity{};
+        GLsizei commandCount{0};
+        std::size_t instanceCount{0};
+    };
+
     void generateInstanceBuffersForCubeTypes();
     void initializeTorchLightVolumeGLParams(int volumeDimension);
+    void initializeSurfaceHeightsGLParams();
+    /** Writes counts[s] positions into the slots of every section s in
+     * sections; false when no count changed. */
+    bool writeSectionInstances(InstanceSlots& slots,
+                               ChunkMesh::SectionMask sections,
+                               const ChunkMesh::SectionCounts& counts,
+                               const std::vector<glm::vec3>& positions);
+    /** Moves the slots into a new buffer sized for counts in sections and
+     * for the current counts elsewhere, copying the kept sections on the
+     * GPU. */
+    void relayoutInstanceSlots(InstanceSlots& slots,
+                               ChunkMesh::SectionMask sections,
+                               const ChunkMesh::SectionCounts& counts);
+    void updateDrawCommands(CubeType type, InstanceSlots& slots);
     void bindInstanceAttributesForType(CubeType type) const;
-    void uploadInstanceBuffer();
-    void drawElements(CubeType type, unsigned amount) const;
+    void drawElements(CubeType type, GLsizei commandCount) const;
+    void initializeQuadGLParams();
+    void drawQuads(CubeType type) const;
 
-    std::unordered_map<CubeType, std::vector<glm::mat4>> instanceMatricesData{};
-    std::unordered_map<CubeType, unsigned> instanceVBOs{};
+    std::unordered_map<CubeType, InstanceSlots> instanceSlots{};
     std::unordered_map<CubeType, unsigned> instanceLightVBOs{};
     GLuint lightVolumeTexture{0};
+    GLuint surfaceHeightsTexture{0};
+    std::unordered_map<CubeType, ChunkMesh::QuadRange> quadRanges{};
+    GLuint quadVAO{0}, quadVBO{0}, quadEBO{0};
+    std::size_t instanceTriangleCount{0};
+    std::size_t quadTriangleCount{0};
 
     unsigned vertexArrayObjects{0}, regularCubeEBO{0}, waterEBO{0};
 };
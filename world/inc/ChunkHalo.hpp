@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include "BlockRegistry.hpp"
+#include "ChunkGeometry.hpp"
+#include "Cube.hpp"
+
+/** The shell of voxels just outside a chunk, copied from its 26 neighbors.
+ * The ring of columns beside the chunk holds four faces of CHUNK_SIZE
+ * columns and four corner columns, addressed by their padded (x, z) where
+ * the chunk itself spans [1, CHUNK_SIZE]; each column is CHUNK_SIZE
+ * contiguous cells from the bottom up, so a neighbor column is copied in one
+ * run. The layers just below and above the chunk cover the whole padded
+ * footprint, PADDED_SIZE^2 cells indexed x-major. */
+class ChunkHalo {
+   public:
+    static constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    static constexpr int PADDED_SIZE{ChunkGeometry::PADDED_CHUNK_SIZE};
+    static constexpr int COLUMN_COUNT{4 * CHUNK_SIZE + 4};
+    static constexpr std::size_t LAYER_CELL_COUNT{
+        static_cast<std::size_t>(PADDED_SIZE) * PADDED_SIZE};
+    enum Layer : int { BELOW, ABOVE };
+
+    ChunkHalo() { clear(); }
+
+    /** Back to all air, as when no neighbor is loaded. */
+    inline void clear() { cells.fill(CubeType::NONE); }
+
+    inline CubeType* column(int paddedX, int paddedZ) {
+        return &cells[columnIndexOf(paddedX, paddedZ) * CHUNK_SIZE];
+    }
+    inline const CubeType* column(int paddedX, int paddedZ) const {
+        return &cells[columnIndexOf(paddedX, paddedZ) * CHUNK_SIZE];
+    }
+
+    inline CubeType* layer(Layer which) {
+        return &cells[RING_CELL_COUNT + which * LAYER_CELL_COUNT];
+    }
+    inline const CubeType* layer(Layer which) const {
+        return &cells[RING_CELL_COUNT + which * LAYER_CELL_COUNT];
+    }
+    static constexpr std::size_t layerIndexOf(int paddedX, int paddedZ) {
+        return static_cast<std::size_t>(paddedX) * PADDED_SIZE + paddedZ;
+    }
+
+    inline bool containsLightSource() const {
+        return std::any_of(cells.cbegin(), cells.cend(),
+                           BlockRegistry::isEmissive);
+    }
+
+    /** Calls visit(paddedX, paddedZ, cells) for every halo column. */
+    template <typename Visitor>
+    void forEachColumn(Visitor&& visit) const {
+        constexpr int LAST{PADDED_SIZE - 1};
+        for (int z = 0; z < PADDED_SIZE; ++z) {
+            visit(0, z, column(0, z));
+            visit(LAST, z, column(LAST, z));
+        }
+        for (int x = 1; x < LAST; ++x) {
+            visit(x, 0, column(x, 0));
+            visit(x, LAST, column(x, LAST));
+        }
+    }
+
+   private:
+    /** West and east edges first, corners included, then the south and
+     * north faces between them. */
+    static constexpr std::size_t columnIndexOf(int paddedX, int paddedZ) {
+        constexpr int LAST{PADDED_SIZE - 1};
+        if (paddedX == 0) {
+            return paddedZ;
+        }
+        if (paddedX == LAST) {
+            return PADDED_SIZE + paddedZ;
+        }
+        return 2 * PADDED_SIZE + (paddedZ == 0 ? 0 : CHUNK_SIZE) + paddedX -
+               1;
+    }
+
+    static constexpr std::size_t RING_CELL_COUNT{
+        static_cast<std::size_t>(COLUMN_COUNT) * CHUNK_SIZE};
+
+    std::array<CubeType, RING_CELL_COUNT + 2 * LAYER_CELL_COUNT> cells{};
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ChunkGeometry.hpp"
+#include "ChunkOccupancy.hpp"
+
+/** Surface of every column of a chunk: the local y just above its highest
+ * solid block, or 0 for a column with none. Built when the chunk is generated
+ * and kept current by each edit, so "where is the ground" is one load. Stored
+ * z-major as bytes, which is also the layout of its GL texture. */
+class ChunkHeightmap {
+   public:
+    static constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    static_assert(CHUNK_SIZE <= UINT8_MAX, "surfaces are stored as bytes");
+
+    inline int surfaceAt(int localX, int localZ) const {
+        return surfaces[indexOf(localX, localZ)];
+    }
+    inline void setSurface(int localX, int localZ, int surface) {
+        surfaces[indexOf(localX, localZ)] = static_cast<std::uint8_t>(surface);
+    }
+    inline const std::uint8_t* data() const { return surfaces.data(); }
+
+    /** Rereads the surface of one column after an edit to it. */
+    inline void update(const ChunkOccupancy& occupancy, int localX,
+                       int localZ) {
+        const auto highestY =
+            occupancy.highestSolidY(localX, localZ, 0, CHUNK_SIZE - 1);
+        setSurface(localX, localZ, highestY.has_value() ? *highestY + 1 : 0);
+    }
+    /** Recomputes every column from occupancy. */
+    void rebuild(const ChunkOccupancy& occupancy) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                update(occupancy, x, z);
+            }
+        }
+    }
+
+   private:
+    static constexpr std::size_t indexOf(int localX, int localZ) {
+        return static_cast<std::size_t>(localZ) * CHUNK_SIZE + localX;
+    }
+
+    std::array<std::uint8_t, CHUNK_SIZE * CHUNK_SIZE> surfaces{};
+};
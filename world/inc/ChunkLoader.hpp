@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <memory>
 #include <future>
+#include <mutex>
 #include <unordered_set>
 #include "CpuChunk.hpp"
 #include "ChunkCoord.hpp"
@@ -10,18 +11,29 @@
 
 class ChunkLoader {
    public:
-    ChunkLoader(int renderingDistance, int sizeOfChunk);
+    /** Saves of evicted chunks, handed to the task to restore. */
+    using SavedChunks =
+        std::unordered_map<ChunkCoord, SavedChunk, ChunkCoordHash>;
+
+    ChunkLoader();
     ~ChunkLoader();
     ChunkLoader(const ChunkLoader&) = delete;
     ChunkLoader(ChunkLoader&&) = delete;
     ChunkLoader& operator=(const ChunkLoader&) = delete;
     ChunkLoader& operator=(ChunkLoader&&) = delete;
+    /** Generates, off the main thread, every chunk of window that is not
+     * in existingKeys; those in savedChunks are restored from their save
+     * instead. Chunks are built nearest the camera's layer first, then
+     * nearest the camera across, and handed out as they are done. */
     void launchTask(
-        int camChunkX, int camChunkZ,
-        const std::unordered_set<ChunkCoord, PositionXYHash>& existingKeys);
+        const ChunkWindow& window, const ChunkCoord& cameraCoord,
+        const std::unordered_set<ChunkCoord, ChunkCoordHash>& existingKeys,
+        SavedChunks&& savedChunks);
     bool isTaskRunning() const;
     bool isFinished() const;
-    std::unique_ptr<RenderableChunk> createChunk(int x, int z);
+    std::unique_ptr<RenderableChunk> createChunk(const ChunkCoord& coord);
+    /** The chunks built since the last call. The task is over once it
+     * returns the last of them. */
     Coord::CpuChunksMap retrieveNewChunks();
     unsigned int getSharedVBO() const { return vertexBufferObjects; }
     unsigned int getSharedEBO() const { return cubeElementBufferObjects; }
@@ -29,16 +41,18 @@ class ChunkLoader {
 
    private:
     void setupVertexBuffers();
-    Coord::CpuChunksMap generateMissingChunks(
-        int camChunkX, int camChunkZ,
-        const std::unordered_set<ChunkCoord, PositionXYHash>& existingKeys);
+    void generateMissingChunks(
+        const ChunkWindow& window, const ChunkCoord& cameraCoord,
+        const std::unordered_set<ChunkCoord, ChunkCoordHash>& existingKeys,
+        const SavedChunks& savedChunks);
     std::vector<Vertex> vertices{};
-    int renderDistance{};
-    int chunkSize{};
     unsigned int vertexBufferObjects{0};
     unsigned int cubeElementBufferObjects{0};
     unsigned int waterElementBufferObjects{0};
 
-    std::future<Coord::CpuChunksMap> newChunkGroup{};
+    std::future<void> newChunkGroup{};
+    /** Guards readyChunks, filled by the task one chunk at a time. */
+    std::mutex readyChunksMutex{};
+    Coord::CpuChunksMap readyChunks{};
     bool isRunning{false};
 };
\ No newline at end of file
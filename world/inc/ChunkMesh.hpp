@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/vec3.hpp>
+#include "Cube.hpp"
+#include "VertexData.hpp"
+#include "VoxelTypes.hpp"
+
+/** How a chunk turns its visible blocks into triangles. */
+enum class MeshingMode : std::uint8_t {
+    /** A whole instanced cube per block with any visible face. */
+    INSTANCED_CUBES,
+    /** Only the visible faces, merged into rectangles per block type. */
+    GREEDY_QUADS,
+};
+
+/** Resolution a chunk is meshed at; each level doubles the edge of the
+ * cells it is drawn with. */
+enum class LodLevel : std::uint8_t {
+    /** One cell per block, in the chunk's meshing mode. */
+    FULL,
+    /** 2x2x2 blocks per cell, as greedy quads. */
+    HALF,
+    /** 4x4x4 blocks per cell, as greedy quads. */
+    QUARTER,
+};
+
+/** Geometry produced by one chunk rebuild, grouped by block type: instanced
+ * cube positions or merged face quads, depending on the meshing mode. Built
+ * on the worker thread and uploaded by ChunkGraphics; the applied mesh is
+ * then kept in the chunk's RetainedMesh, to restore the chunk from after
+ * eviction. Instances are listed section by section, so a rebuild of a few
+ * sections replaces just their share of the instances. */
+struct ChunkMesh {
+    /** Indices [firstIndex, firstIndex + indexCount) of quadIndices. */
+    struct QuadRange {
+        unsigned firstIndex{0};
+        unsigned indexCount{0};
+    };
+    static constexpr std::size_t TRIANGLES_PER_CUBE{12};
+    static constexpr int SECTION_COUNT{VoxelTypes::VoxelGrid3D::SECTION_COUNT};
+    /** One bit per section, in VoxelGrid3D section order. */
+    using SectionMask = std::uint64_t;
+    static_assert(SECTION_COUNT <= 64, "a section mask must fit in 64 bits");
+    static constexpr SectionMask ALL_SECTIONS{~SectionMask{0}};
+    using SectionCounts = std::array<unsigned, SECTION_COUNT>;
+
+    /** Sections the instances were built for: all of them, or the dirty
+     * ones of a section rebuild. */
+    SectionMask sections{ALL_SECTIONS};
+    std::unordered_map<CubeType, std::vector<glm::vec3>> instancePositions{};
+    /** How many of instancePositions each section holds, per block type. */
+    std::unordered_map<CubeType, SectionCounts> sectionInstanceCounts{};
+    std::vector<Vertex> quadVertices{};
+    std::vector<unsigned> quadIndices{};
+    std::unordered_map<CubeType, QuadRange> quadRanges{};
+
+    std::size_t countTriangles() const {
+        std::size_t triangles{quadIndices.size() / 3};
+        for (const auto& [type, positions] : instancePositions) {
+            triangles += positions.size() * TRIANGLES_PER_CUBE;
+        }
+        return triangles;
+    }
+};
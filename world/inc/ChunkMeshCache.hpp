@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include "ChunkCoord.hpp"
+#include "RetainedMesh.hpp"
+
+/** Meshes of evicted chunks, kept within a byte budget so that a chunk
+ * coming back into the window is drawn again without a rebuild. When the
+ * budget runs out, the meshes stored longest ago are dropped first; their
+ * chunks are then rebuilt as before. */
+class ChunkMeshCache {
+   public:
+    static constexpr std::size_t DEFAULT_BUDGET_BYTES{std::size_t{64} << 20};
+
+    explicit ChunkMeshCache(std::size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+    ChunkMeshCache(const ChunkMeshCache&) = delete;
+    ChunkMeshCache& operator=(const ChunkMeshCache&) = delete;
+    ChunkMeshCache(ChunkMeshCache&&) = delete;
+    ChunkMeshCache& operator=(ChunkMeshCache&&) = delete;
+    ~ChunkMeshCache() = default;
+
+    /** Drops the oldest meshes until the rest fit; 0 keeps none. */
+    void setBudget(std::size_t budgetBytes);
+    /** Stores the mesh of coord, replacing any older one. A mesh larger
+     * than the whole budget is not kept. */
+    void insert(const ChunkCoord& coord, RetainedMesh&& mesh);
+    /** Removes the mesh of coord and hands it over, if one is kept. */
+    std::optional<RetainedMesh> take(const ChunkCoord& coord);
+    /** Forgets the mesh of coord, which no longer matches the chunk or its
+     * neighbors. */
+    void erase(const ChunkCoord& coord);
+    void clear();
+    inline std::size_t getResidentBytes() const { return residentBytes; }
+
+   private:
+    struct Entry {
+        ChunkCoord coord{};
+        RetainedMesh mesh{};
+        std::size_t bytes{0};
+    };
+    using EntryList = std::list<Entry>;
+
+    void eraseEntry(EntryList::iterator entry);
+    void dropOldestOverBudget();
+
+    /** Most recently stored first. */
+    EntryList entries{};
+    std::unordered_map<ChunkCoord, EntryList::iterator, ChunkCoordHash>
+        index{};
+    std::size_t budgetBytes{0};
+    std::size_t residentBytes{0};
+};
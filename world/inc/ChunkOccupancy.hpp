@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <glm/vec3.hpp>
+#include "ChunkGeometry.hpp"
+#include "VoxelTypes.hpp"
+
+/** One bit per cell telling whether it holds a solid block, packed as a
+ * 64-bit mask per (x, z) column with bit y for local height y. Kept next to
+ * the voxel grid and updated by every edit, so solid-versus-empty questions
+ * about a cell or a vertical span are a load and a few bit operations. */
+class ChunkOccupancy {
+   public:
+    using ColumnMask = std::uint64_t;
+    static constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    static_assert(CHUNK_SIZE == 64, "a column must fill one 64-bit mask");
+
+    inline ColumnMask columnAt(int localX, int localZ) const {
+        return columns[indexOf(localX, localZ)];
+    }
+    inline bool isSolidAt(const glm::ivec3& localPos) const {
+        return (columnAt(localPos.x, localPos.z) >> localPos.y) & 1u;
+    }
+    inline void set(const glm::ivec3& localPos, bool solid) {
+        auto& column = columns[indexOf(localPos.x, localPos.z)];
+        const ColumnMask bit{ColumnMask{1} << localPos.y};
+        column = solid ? column | bit : column & ~bit;
+    }
+
+    /** Lowest solid y in [minY, maxY] of the column, if any. */
+    inline std::optional<int> lowestSolidY(int localX, int localZ, int minY,
+                                           int maxY) const {
+        const auto span = columnAt(localX, localZ) & spanMask(minY, maxY);
+        if (span == 0) {
+            return std::nullopt;
+        }
+        return std::countr_zero(span);
+    }
+    /** Highest solid y in [minY, maxY] of the column, if any. */
+    inline std::optional<int> highestSolidY(int localX, int localZ, int minY,
+                                            int maxY) const {
+        const auto span = columnAt(localX, localZ) & spanMask(minY, maxY);
+        if (span == 0) {
+            return std::nullopt;
+        }
+        return CHUNK_SIZE - 1 - std::countl_zero(span);
+    }
+
+    /** Recomputes every column of grid. */
+    void rebuild(const VoxelTypes::VoxelGrid3D& grid);
+
+   private:
+    static constexpr std::size_t indexOf(int localX, int localZ) {
+        return static_cast<std::size_t>(localZ) * CHUNK_SIZE + localX;
+    }
+    /** Bits minY to maxY inclusive, both within [0, CHUNK_SIZE). */
+    static constexpr ColumnMask spanMask(int minY, int maxY) {
+        return (~ColumnMask{0} >> (CHUNK_SIZE - 1 - maxY)) &
+               (~ColumnMask{0} << minY);
+    }
+
+    std::array<ColumnMask, CHUNK_SIZE * CHUNK_SIZE> columns{};
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "ChunkCoord.hpp"
+#include "ChunkUpdater.hpp"
+#include "RenderableChunk.hpp"
+#include "SavedChunk.hpp"
+
+/** Everything World keeps for one chunk coordinate. A loaded chunk has a
+ * renderable and its updater; an evicted, edited chunk only its save. */
+struct ChunkSlot {
+    std::unique_ptr<RenderableChunk> renderable{};
+    std::unique_ptr<ChunkUpdater> updater{};
+    std::optional<SavedChunk> saved{};
+
+    inline bool isEmpty() const {
+        return not renderable and not updater and not saved.has_value();
+    }
+};
+
+/** Open-addressing hash table from chunk coordinates to their ChunkSlot,
+ * stored in one flat array and probed linearly from hashChunkCoord. Erasing
+ * leaves a tombstone until the next rehash, so forEach may erase the entry
+ * it is visiting. Inserting may rehash and invalidates ChunkSlot pointers;
+ * the chunks they own stay where they are. */
+class ChunkTable {
+   public:
+    ChunkTable();
+    ChunkTable(const ChunkTable&) = delete;
+    ChunkTable& operator=(const ChunkTable&) = delete;
+    ChunkTable(ChunkTable&&) = delete;
+    ChunkTable& operator=(ChunkTable&&) = delete;
+    ~ChunkTable() = default;
+
+    ChunkSlot* find(const ChunkCoord& coord);
+    const ChunkSlot* find(const ChunkCoord& coord) const;
+    RenderableChunk* findRenderable(const ChunkCoord& coord) const;
+    /** Returns the slot of coord, adding an empty one if there is none. */
+    ChunkSlot& findOrInsert(const ChunkCoord& coord);
+    /** Drops the entry of coord once its slot holds nothing. */
+    void eraseIfEmpty(const ChunkCoord& coord);
+    inline std::size_t size() const { return occupiedCount; }
+
+    /** Calls visit(coord, slot) for every entry, in table order. */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) {
+        for (auto& entry : entries) {
+            if (entry.state == EntryState::OCCUPIED) {
+                visit(static_cast<const ChunkCoord&>(entry.coord), entry.slot);
+            }
+        }
+    }
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const auto& entry : entries) {
+            if (entry.state == EntryState::OCCUPIED) {
+                visit(entry.coord, entry.slot);
+            }
+        }
+    }
+    /** Calls visit(coord, chunk) for every loaded chunk. */
+    template <typename Visitor>
+    void forEachRenderable(Visitor&& visit) {
+        forEach([&visit](const ChunkCoord& coord, ChunkSlot& slot) {
+            if (slot.renderable) {
+                visit(coord, *slot.renderable);
+            }
+        });
+    }
+
+   private:
+    enum class EntryState : std::uint8_t { EMPTY, OCCUPIED, TOMBSTONE };
+    struct Entry {
+        ChunkCoord coord{};
+        EntryState state{EntryState::EMPTY};
+        ChunkSlot slot{};
+    };
+
+    /** Index of the entry holding coord, or of the first free entry on its
+     * probe sequence when absent; `found` tells the two apart. */
+    std::size_t probe(const ChunkCoord& coord, bool& found) const;
+    void rehash(std::size_t newCapacity);
+    bool needsRehashBeforeInsert() const;
+
+    std::vector<Entry> entries{};
+    std::size_t occupiedCount{0};
+    std::size_t tombstoneCount{0};
+};
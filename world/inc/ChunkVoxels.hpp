@@ -1,79 +1,242 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <glm/gtc/matrix_transform.hpp>
 #include "GridGenerator.hpp"
 #include "TreeGenerator.hpp"
+#include "BlockStateTable.hpp"
+#include "ChunkFaceMasks.hpp"
+#include "ChunkHalo.hpp"
+#include "ChunkHeightmap.hpp"
+#include "ChunkOccupancy.hpp"
 #include "CubeData.hpp"
 #include "VoxelTypes.hpp"
 #include "RenderableWaterMesh.hpp"
 #include "CpuWaterMesh.hpp"
 #include "WaterMeshBuilder.hpp"
+#include "PackedVoxels.hpp"
+#include "SavedChunk.hpp"
+#include "ChunkCoord.hpp"
+
+/** Counts a snapshot among the readers of a chunk's grid until it is
+ * destroyed or released. The release is a release store, paired with the
+ * acquire load the chunk makes before writing the grid in place, so every
+ * read of the snapshot happens before that write. */
+class GridReadLease {
+   public:
+    GridReadLease() = default;
+    explicit GridReadLease(std::shared_ptr<std::atomic<int>> gridReaders);
+    ~GridReadLease();
+
+    GridReadLease(const GridReadLease&) = delete;
+    GridReadLease& operator=(const GridReadLease&) = delete;
+    GridReadLease(GridReadLease&& other) noexcept = default;
+    GridReadLease& operator=(GridReadLease&& other) noexcept;
+
+    void release();
+
+   private:
+    std::shared_ptr<std::atomic<int>> readers{};
+};
+
+/** Everything a rebuild reads, frozen when the rebuild is launched. The
+ * grid is shared with the chunk until the chunk is next edited. */
+struct ChunkSnapshot {
+    std::uint64_t version{0};
+    std::shared_ptr<const VoxelTypes::VoxelGrid3D> voxelGrid{};
+    BlockStateTable blockStates{};
+    std::vector<glm::ivec3> torchPositions{};
+    ChunkHalo neighborHalo{};
+    /** Sides whose border faces are kept whatever the halo holds. */
+    ChunkFaceMasks::FaceSet openBorderFaces{0};
+    ChunkHeightmap heightmap{};
+    glm::vec3 chunkOrigin{};
+    MeshingMode meshingMode{MeshingMode::INSTANCED_CUBES};
+    LodLevel lodLevel{LodLevel::FULL};
+    RebuildScope scope{RebuildScope::FULL};
+    /** The sections a SECTIONS rebuild remeshes. */
+    ChunkMesh::SectionMask dirtySections{0};
+    /** Held until the snapshot is destroyed, after the rebuild is done. */
+    GridReadLease gridLease{};
+};
 
 class ChunkVoxels {
    public:
-    ChunkVoxels(int size, int worldX, int worldZ);
+    struct BulkWriteResult {
+        std::size_t changedCount{0};
+        /** A light source was placed or removed. */
+        bool lightSourcesChanged{false};
+    };
+
+    explicit ChunkVoxels(const ChunkCoord& chunkCoord);
+    /** Rebuilds an evicted chunk: regenerates it and replays the saved
+     * edits, or unpacks the saved grid. */
+    static ChunkVoxels restore(const ChunkCoord& chunkCoord,
+                               const SavedChunk& savedChunk);
     ChunkVoxels(const ChunkVoxels&) = delete;
     ChunkVoxels& operator=(const ChunkVoxels&) = delete;
     ChunkVoxels(ChunkVoxels&& other) noexcept;
     ChunkVoxels& operator=(ChunkVoxels&& other) noexcept;
 
-    inline int getSize() const { return size; }
-    inline bool isModified() const { return modified; }
+    /** True when the chunk changed since the last rebuild was launched. */
+    inline bool isModified() const { return editVersion != snapshotVersion; }
+    /** Nothing but air, which has nothing to draw; exact while the grid
+     * is compacted. */
+    inline bool isAllAir() const {
+        return voxelGrid->isUniform(CubeType::NONE);
+    }
 
     bool addCube(const glm::ivec3& localPos, CubeType type);
     bool removeCube(const glm::ivec3& localPos);
     bool isCubeInGrid(const glm::ivec3& localPos) const;
+    /** Overwrites many cells under a single lock. Cells that already hold
+     * their new type and state are skipped. */
+    BulkWriteResult writeVoxels(
+        const std::vector<VoxelTypes::VoxelWrite>& writes);
 
-    const std::unordered_map<CubeType, std::vector<glm::mat4>>&
-    getInstanceModelMatrices() const;
     glm::vec3 getChunkOrigin() const;
 
     CubeType getCubeTypeAt(const glm::ivec3& localPos) const;
+    /** The block id and state at localPos. */
+    Voxel getVoxelAt(const glm::ivec3& localPos) const;
+    /** Sets the state of the stateful block at localPos. False when there is
+     * no such block. */
+    bool setBlockState(const glm::ivec3& localPos, BlockState state);
+    /** Local y just above the highest solid block of a column, 0 if none. */
+    inline int getSurfaceHeight(int localX, int localZ) const {
+        return heightmap.surfaceAt(localX, localZ);
+    }
+    inline const ChunkOccupancy& getOccupancy() const { return occupancy; }
+    /** Copies the CHUNK_SIZE cells of column (localX, localZ), bottom up. */
+    void readColumn(int localX, int localZ, CubeType* out) const;
+    /** Empty when the chunk can be regenerated as is. */
+    std::optional<SavedChunk> save() const;
+    /** Freezes the current state for a rebuild, tagged with the current
+     * edit version. Edits made while it runs leave the chunk modified. */
+    ChunkSnapshot takeSnapshot();
+    /** Lights and meshes a snapshot; safe to run on any thread. */
+    static CubeData computeCubeData(ChunkSnapshot snapshot);
     CubeData computeCubeData();
+    /** Meshes the solid blocks of grid with a visible face, found with
+     * ChunkFaceMasks against the neighbor cells in halo, except on the
+     * sides in openFaces: an instance per block, or their merged faces.
+     * Instances are emitted only for the given sections; merged faces
+     * always cover the whole chunk. */
+    static void processVoxelGrid(
+        const VoxelTypes::VoxelGrid3D& grid, const ChunkHalo& halo,
+        const glm::vec3& chunkOrigin, MeshingMode meshingMode, ChunkMesh& mesh,
+        ChunkMesh::SectionMask sections = ChunkMesh::ALL_SECTIONS,
+        ChunkFaceMasks::FaceSet openFaces = 0);
     std::pair<glm::vec3, glm::vec3> computeChunkAABB() const;
 
-    void setModified(bool value);
-    void setNeighborsSurroundingCubes(VoxelTypes::NeighborVoxelsMap&& data);
-    void clearNeighborsSurroundingCubes();
-    void storeCubes(std::vector<std::unique_ptr<Cube>>&& newCubes);
-
-    const std::vector<CpuWaterMesh>& getWaterMeshData() const {
-        return waterMeshData;
+    /** Bumps the edit version without touching the voxels, for changes
+     * of the neighbors. */
+    void markModified();
+    /** Bumps the edit version for a change of the neighbor cells along the
+     * border, which only hides or shows border faces: the next rebuild
+     * remeshes without relighting, unless something else changed too. */
+    void markBorderModified();
+    /** Records a finished rebuild of the given version as applied. False
+     * when a rebuild at least as recent was applied already. */
+    bool acceptRebuild(std::uint64_t version);
+    /** True when the last applied rebuild is of the current version, so
+     * what the chunk draws matches its voxels, mode and level. */
+    bool isRebuildCurrent() const;
+    /** Records a rebuild of version, built before the chunk was evicted
+     * with the given mode, level and open faces, as launched and applied.
+     * The chunk is then unmodified until it changes again. */
+    void adoptRebuild(std::uint64_t version, MeshingMode mode, LodLevel level,
+                      ChunkFaceMasks::FaceSet openFaces);
+    void setNeighborHalo(const ChunkHalo& halo);
+    /** Sides facing a neighbor drawn at another level of detail, whose
+     * cells do not match what it draws; set along with the halo. */
+    void setOpenBorderFaces(ChunkFaceMasks::FaceSet faces);
+    /** Switching modes leaves the chunk modified, to be meshed again. */
+    void setMeshingMode(MeshingMode mode);
+    /** Switching levels leaves the chunk modified, to be meshed again. */
+    void setLodLevel(LodLevel level);
+    inline MeshingMode getMeshingMode() const { return meshingMode; }
+    inline LodLevel getLodLevel() const { return lodLevel; }
+    inline ChunkFaceMasks::FaceSet getOpenBorderFaces() const {
+        return openBorderFaces;
     }
-    void buildWaterMeshData();
+    /** Collapses sections that edits left holding a single block type,
+     * unless a snapshot still shares the grid. */
+    void compactSections();
+
+    /** Water mesh of the grid as generated or restored. */
+    const CpuWaterMesh& getWaterMesh() const { return waterMesh; }
 
    private:
-    using CubeCreator = std::function<void(const glm::ivec3&, CubeType)>;
+    ChunkVoxels(const ChunkCoord& chunkCoord,
+                const PackedVoxels& packedVoxels);
+    /** The move itself, run while otherLock holds the mutex of other, as
+     * a snapshot may still be taken from it. */
+    ChunkVoxels(ChunkVoxels&& other,
+                const std::lock_guard<std::mutex>& otherLock) noexcept;
 
-    VoxelTypes::VoxelGrid3D generateInitialVoxelGrid();
-    void createCube(const glm::ivec3& worldPos, CubeType type);
-    void processVoxelGrid(float firstCubeX, float firstCubeZ,
-                          const CubeCreator& action);
-    void regenerateChunk(const CubeCreator& action);
-    void rebuildCubesFromGrid();
+    /** The grid to write to. Must be called with voxelMutex held; a grid
+     * that a snapshot still reads is copied first. */
+    VoxelTypes::VoxelGrid3D& mutableGrid();
+    /** True while a snapshot leases the grid. Must be called with
+     * voxelMutex held. */
+    bool isGridLeased() const;
+    /** The type a write of cubeType at localPos stores: air dug at sea
+     * level turns into water. */
+    CubeType resolveWriteType(const glm::ivec3& localPos,
+                              CubeType cubeType) const;
+    /** A state is kept only for stateful block types. */
+    void writeVoxel(const glm::ivec3& localPos, CubeType type,
+                    BlockState state = 0);
+    void replayEdits(const std::vector<SavedChunk::VoxelEdit>& savedEdits);
+    void widenPendingScope(RebuildScope scope);
+    /** Marks the sections whose faces an edit at localPos can change: its
+     * own and those of its six neighbors. */
+    void markSectionsAround(const glm::ivec3& localPos);
+    void collectTorchPositions();
 
+    /** Floods the air at sea level, in the layer that holds it. */
     void placeWaterBlocks();
-    glm::vec2 computeChunkWorldPosition() const;
-    void storeValidWaterSurfaces(
-        const std::vector<WaterMeshBuilder::WaterSurface>& surfaces);
 
-    int size{0};
-    int chunkWorldXIndex{0};
-    int chunkWorldZIndex{0};
+    ChunkCoord chunkCoord{};
 
     TreeGenerator treeGenerator;
-    VoxelTypes::VoxelGrid3D voxelGrid{};
-    std::vector<std::unique_ptr<Cube>> cubes{};
-    std::unordered_map<CubeType, std::vector<glm::mat4>>
-        instanceModelMatrices{};
+    /** Declared before the grid, which fills it while generating. */
+    ChunkHeightmap heightmap{};
+    ChunkOccupancy occupancy{};
+    std::shared_ptr<VoxelTypes::VoxelGrid3D> voxelGrid;
+    /** Snapshots holding a lease on voxelGrid. A fresh counter comes with
+     * every copy of the grid. */
+    std::shared_ptr<std::atomic<int>> gridReaders{
+        std::make_shared<std::atomic<int>>(0)};
+    /** States of the stateful blocks in voxelGrid; copied into snapshots,
+     * which is cheap while it stays sparse. */
+    BlockStateTable blockStates{};
     std::vector<glm::ivec3> torchPositions{};
-    VoxelTypes::NeighborVoxelsMap neighborsSurroundingCubes{};
+    ChunkHalo neighborHalo{};
+    ChunkFaceMasks::FaceSet openBorderFaces{0};
+    VoxelTypes::VoxelEditsMap edits{};
+    /** Restored from a packed grid: edits alone no longer describe it. */
+    bool savedAsPackedGrid{false};
+    MeshingMode meshingMode{MeshingMode::INSTANCED_CUBES};
+    LodLevel lodLevel{LodLevel::FULL};
+    /** What the changes since the last snapshot need rebuilt. SECTIONS
+     * with no dirty section means nothing changed. */
+    RebuildScope pendingScope{RebuildScope::FULL};
+    ChunkMesh::SectionMask dirtySections{0};
 
-    std::vector<CpuWaterMesh> waterMeshData{};
+    CpuWaterMesh waterMesh{};
 
-    bool modified{true};
+    /** Incremented by every change; a new chunk starts out modified. */
+    std::uint64_t editVersion{1};
+    std::uint64_t snapshotVersion{0};
+    std::uint64_t appliedVersion{0};
+    /** Guards the grid pointer, the halo and the versions. Held only
+     * for edits and snapshots, never while a rebuild runs. */
     mutable std::mutex voxelMutex;
 };
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "ChunkCoord.hpp"
+#include "ChunkTable.hpp"
+#include "RenderableChunk.hpp"
+
+/** Direct-mapped index of the loaded chunks around the camera. Cells form a
+ * 3D torus addressed by chunk coordinate modulo power-of-two extents larger
+ * than the window, so no two chunks of the window share a cell and a lookup
+ * is an array index plus a coordinate check. Every loaded chunk inside the
+ * window is indexed; chunks still loaded outside it keep their cell only
+ * while nothing in the window needs it, and otherwise are found through
+ * the ChunkTable. The window spans renderDistance chunks horizontally and
+ * verticalRenderDistance layers vertically, clamped to the world height. */
+class ChunkWindowIndex {
+   public:
+    ChunkWindowIndex(const ChunkTable& chunkTable, int renderDistance,
+                     int verticalRenderDistance);
+    ChunkWindowIndex(const ChunkWindowIndex&) = delete;
+    ChunkWindowIndex& operator=(const ChunkWindowIndex&) = delete;
+    ChunkWindowIndex(ChunkWindowIndex&&) = delete;
+    ChunkWindowIndex& operator=(ChunkWindowIndex&&) = delete;
+    ~ChunkWindowIndex() = default;
+
+    RenderableChunk* find(const ChunkCoord& coord) const;
+    void insert(const ChunkCoord& coord, RenderableChunk* chunk);
+    void erase(const ChunkCoord& coord);
+    /** Moves the window; only cells of the chunks scrolling in are
+     * refreshed from the table. */
+    void recenter(const ChunkCoord& center);
+    inline const ChunkWindow& getWindow() const { return window; }
+
+   private:
+    struct Cell {
+        ChunkCoord coord{};
+        RenderableChunk* chunk{nullptr};
+    };
+
+    inline std::size_t cellIndexOf(const ChunkCoord& coord) const {
+        return (static_cast<std::size_t>(coord.y & heightMask) * width +
+                (coord.z & mask)) *
+                   width +
+               (coord.x & mask);
+    }
+    inline Cell& cellAt(const ChunkCoord& coord) {
+        return cells[cellIndexOf(coord)];
+    }
+    inline const Cell& cellAt(const ChunkCoord& coord) const {
+        return cells[cellIndexOf(coord)];
+    }
+    ChunkWindow windowAround(const ChunkCoord& center) const;
+
+    const ChunkTable& table;
+    int radius{0};
+    int verticalRadius{0};
+    int width{0};
+    int mask{0};
+    int height{0};
+    int heightMask{0};
+    ChunkWindow window{};
+    std::vector<Cell> cells{};
+};
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "ChunkVoxels.hpp"
-#include "CubeData.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 
@@ -9,7 +8,7 @@ class RenderableChunk;
 
 class CpuChunk {
    public:
-    CpuChunk(int size, int worldX, int worldZ);
+    explicit CpuChunk(const ChunkCoord& chunkCoord);
     CpuChunk(ChunkVoxels&& voxels);
     CpuChunk(CpuChunk&&) = default;
     CpuChunk& operator=(CpuChunk&&) = default;
@@ -17,16 +16,10 @@ class CpuChunk {
     CpuChunk& operator=(const CpuChunk&) = delete;
     ~CpuChunk() = default;
 
-    bool addCube(const glm::ivec3& pos, CubeType type);
-    bool removeCube(const glm::ivec3& pos);
     bool isCubeInGrid(const glm::ivec3& pos) const;
     bool isModified() const;
 
-    CubeData computeCubeData();
-    void applyCubeData(CubeData&& data);
-
     std::pair<glm::vec3, glm::vec3> computeChunkAABB() const;
-    const auto& getInstanceModelMatrices() const;
 
     std::unique_ptr<RenderableChunk> toRenderable(unsigned sharedVBO,
                                                   unsigned sharedCubeEBO,
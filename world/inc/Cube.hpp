@@ -1,8 +1,7 @@
 #pragma once
-#include <vector>
-#include <glm/gtc/matrix_transform.hpp>
+#include <cstdint>
 
-enum class CubeType {
+enum class CubeType : std::uint8_t {
     NONE,
     SAND,
     DIRT,
@@ -14,20 +13,12 @@ enum class CubeType {
     TORCH
 };
 
-class Cube {
-   public:
-    Cube(const glm::vec3& position, CubeType type);
-    Cube(const Cube&) = delete;
-    Cube(Cube&&) = delete;
-    Cube& operator=(const Cube&) = delete;
-    Cube& operator=(Cube&&) = delete;
-    ~Cube();
-    inline glm::vec3 getPosition() const { return position; }
-    inline glm::mat4 getModel() const { return model; }
-    inline CubeType getType() const { return currentType; }
+/** Extra per-voxel data of stateful blocks, such as the flow level of
+ * flowing water. 0 is the default state every other block has. */
+using BlockState = std::uint8_t;
 
-   private:
-    glm::vec3 position{0.0f, 0.0f, 0.0f};
-    glm::mat4 model{1.0f};
-    CubeType currentType{CubeType::GRASS};
-};
\ No newline at end of file
+/** A block id together with its state. */
+struct Voxel {
+    CubeType type{CubeType::NONE};
+    BlockState state{0};
+};
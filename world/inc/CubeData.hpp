@@ -1,15 +1,29 @@
 #pragma once
-#include <memory>
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
-#include <glm/gtc/matrix_transform.hpp>
-#include "Cube.hpp"
+#include "ChunkHeightmap.hpp"
+#include "ChunkMesh.hpp"
+#include "CpuWaterMesh.hpp"
+
+/** How much of a chunk a rebuild recomputes, narrowest first. */
+enum class RebuildScope : std::uint8_t {
+    /** The instances of the dirty sections, and the heights. */
+    SECTIONS,
+    /** The whole mesh; light, water and heights are kept. */
+    MESH,
+    /** Mesh, light, water and heights. */
+    FULL,
+};
 
 /** Small data struct passed between the background thread and the main thread.
  */
 struct CubeData {
-    std::vector<std::unique_ptr<Cube>> cubes{};
-    std::unordered_map<CubeType, std::vector<glm::mat4>>
-        instanceModelMatrices{};
+    /** Edit version of the snapshot this was built from. */
+    std::uint64_t version{0};
+    /** Members the scope leaves out stay empty; the chunk keeps its own. */
+    RebuildScope scope{RebuildScope::FULL};
+    ChunkMesh mesh{};
     std::vector<float> lightVolume{};
-};
\ No newline at end of file
+    CpuWaterMesh waterMesh{};
+    ChunkHeightmap heightmap{};
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include "ChunkFaceMasks.hpp"
+#include "ChunkMesh.hpp"
+#include "VoxelTypes.hpp"
+
+/** Greedy face meshing. For each face direction and each slice of the chunk
+ * across it, the visible faces are merged into maximal rectangles of one
+ * block type: grown along the first slice axis, then along the second while
+ * every cell of the next row matches. Texture coordinates span the whole
+ * rectangle in blocks, so repeating textures tile exactly as they do on
+ * instanced cubes. */
+namespace GreedyMesher {
+/** Appends the merged quads of grid to mesh, grouped by block type. */
+void buildQuads(const VoxelTypes::VoxelGrid3D& grid,
+                const ChunkFaceMasks& masks, const glm::vec3& chunkOrigin,
+                ChunkMesh& mesh);
+} // namespace GreedyMesher
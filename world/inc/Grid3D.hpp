@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <glm/vec3.hpp>
+
+/** Dimension^3 grid of trivially copyable cells in a single
+ * cache-line-aligned allocation. Cells are laid out x-major, then z, with y
+ * innermost, so every (x, z) column is one contiguous run of Dimension cells.
+ * The dimension is a template parameter so index math folds to constants. */
+template <typename T, int Dimension>
+class Grid3D {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Grid3D cells are copied and filled as raw memory");
+    static_assert(Dimension > 0, "Grid3D needs at least one cell");
+
+   public:
+    static constexpr std::size_t CACHE_LINE_SIZE{64};
+    static constexpr std::size_t CELL_COUNT{
+        static_cast<std::size_t>(Dimension) * Dimension * Dimension};
+
+    explicit Grid3D(T fillValue = T{}) : cells{allocateCells()} {
+        fill(fillValue);
+    }
+    Grid3D(const Grid3D& other) : cells{allocateCells()} {
+        std::copy_n(other.data(), CELL_COUNT, data());
+    }
+    Grid3D& operator=(const Grid3D& other) {
+        if (this != &other) {
+            if (not cells) {
+                cells = allocateCells();
+            }
+            std::copy_n(other.data(), CELL_COUNT, data());
+        }
+        return *this;
+    }
+    Grid3D(Grid3D&& other) noexcept = default;
+    Grid3D& operator=(Grid3D&& other) noexcept = default;
+    ~Grid3D() = default;
+
+    static constexpr int getDimension() { return Dimension; }
+    static constexpr std::size_t indexOf(int x, int y, int z) {
+        return (static_cast<std::size_t>(x) * Dimension + z) * Dimension + y;
+    }
+
+    inline T& operator()(int x, int y, int z) {
+        return cells[indexOf(x, y, z)];
+    }
+    inline const T& operator()(int x, int y, int z) const {
+        return cells[indexOf(x, y, z)];
+    }
+    inline T& operator[](const glm::ivec3& pos) {
+        return cells[indexOf(pos.x, pos.y, pos.z)];
+    }
+    inline const T& operator[](const glm::ivec3& pos) const {
+        return cells[indexOf(pos.x, pos.y, pos.z)];
+    }
+
+    inline T* column(int x, int z) { return &cells[indexOf(x, 0, z)]; }
+    inline const T* column(int x, int z) const {
+        return &cells[indexOf(x, 0, z)];
+    }
+    inline T* data() { return cells.get(); }
+    inline const T* data() const { return cells.get(); }
+
+    void fill(T value) {
+        if (cells) {
+            std::fill_n(data(), CELL_COUNT, value);
+        }
+    }
+
+   private:
+    struct AlignedDeleter {
+        void operator()(T* ptr) const {
+            ::operator delete[](ptr, std::align_val_t{CACHE_LINE_SIZE});
+        }
+    };
+    using CellStorage = std::unique_ptr<T[], AlignedDeleter>;
+
+    static CellStorage allocateCells() {
+        return CellStorage{static_cast<T*>(::operator new[](
+            CELL_COUNT * sizeof(T), std::align_val_t{CACHE_LINE_SIZE}))};
+    }
+
+    CellStorage cells{};
+};
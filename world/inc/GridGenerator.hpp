@@ -1,22 +1,23 @@
 #pragma once
 
 #include <vector>
-#include "FastNoiseLite.h"
+#include "ChunkCoord.hpp"
+#include "ChunkHeightmap.hpp"
 #include "Cube.hpp"
+#include "TerrainHeightField.hpp"
 #include "VoxelTypes.hpp"
 
 class GridGenerator {
    public:
-    GridGenerator(int chunkSize, int worldXIndex, int worldZIndex);
+    explicit GridGenerator(const ChunkCoord& chunkCoord);
     GridGenerator(const GridGenerator&) = delete;
     GridGenerator(GridGenerator&&) = delete;
     GridGenerator& operator=(const GridGenerator&) = delete;
     GridGenerator& operator=(GridGenerator&&) = delete;
-    VoxelTypes::VoxelGrid3D generateGrid();
+    /** Fills heightmap with the terrain surface as a side product. */
+    VoxelTypes::VoxelGrid3D generateGrid(ChunkHeightmap& heightmap);
 
    private:
-    int chunkSize{};
-    int chunkWorldXIndex{};
-    int chunkWorldZIndex{};
-    FastNoiseLite noise{};
+    ChunkCoord chunkCoord{};
+    TerrainHeightField heightField{};
 };
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <glm/vec3.hpp>
+#include "TerrainHeightField.hpp"
+#include "VertexData.hpp"
+
+/** Low-poly heightfield of one square tile of the terrain, built straight
+ * from TerrainHeightField without generating any voxels.
+ * It is drawn past the loaded chunks. */
+struct CpuHorizonMesh {
+    std::vector<HorizonVertex> vertices{};
+    std::vector<unsigned> indices{};
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+};
+
+namespace HorizonMeshBuilder {
+constexpr int TILE_SHIFT{9};
+/** Edge of a tile in blocks: eight chunks. */
+constexpr int TILE_SIZE{1 << TILE_SHIFT};
+/** Blocks between two height samples. A tile then takes fewer noise
+ * samples than a single chunk, while the hills still read as hills from
+ * past the chunk window. */
+constexpr int SAMPLE_STEP{16};
+
+/** Index of the tile holding a world block coordinate; floors like
+ * ChunkGeometry::toChunkIndex. */
+constexpr int toTileIndex(int worldCoord) { return worldCoord >> TILE_SHIFT; }
+
+/** The surface over [tileX, tileX + 1) x [tileZ, tileZ + 1) in tile units,
+ * sampled every SAMPLE_STEP blocks. Edge samples fall on the same columns
+ * as those of the next tile, so neighboring tiles meet without cracks. The
+ * surface sits on top of the highest block, or of the sea where the ground
+ * is below it. */
+CpuHorizonMesh buildTile(const TerrainHeightField& heightField, int tileX,
+                         int tileZ);
+} // namespace HorizonMeshBuilder
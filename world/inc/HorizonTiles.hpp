@@ -0,0 +1,45 @@
+#pragma once
+#include <map>
+#include <utility>
+#include <glm/vec3.hpp>
+#include "ChunkCoord.hpp"
+#include "Frustum.hpp"
+#include "RenderableHorizonTile.hpp"
+#include "Shader.hpp"
+#include "TerrainHeightField.hpp"
+
+/** The terrain past the loaded chunks, drawn as heightfield tiles streamed
+ * in around the camera. Tiles cover the chunk window as well; the shader
+ * drops what falls inside it, so the chunks take over exactly where they
+ * are loaded. */
+class HorizonTiles {
+   public:
+    HorizonTiles() = default;
+    HorizonTiles(const HorizonTiles&) = delete;
+    HorizonTiles(HorizonTiles&&) = delete;
+    HorizonTiles& operator=(const HorizonTiles&) = delete;
+    HorizonTiles& operator=(HorizonTiles&&) = delete;
+
+    /** Drops the tiles left out of range, builds a few of the missing ones,
+     * nearest first, and moves the hole cut for the chunk window. */
+    void update(const glm::vec3& cameraPosition, const ChunkWindow& window);
+    void performFrustumCulling(const Frustum& frustum);
+    void render(Shader& shader);
+
+   private:
+    struct Tile {
+        RenderableHorizonTile mesh;
+        bool isCulled{false};
+    };
+    using TileKey = std::pair<int, int>;
+
+    void buildMissingTiles(const TileKey& cameraTile);
+    /** True when the chunk window hides all of tile. */
+    bool isHiddenByChunks(const Tile& tile) const;
+
+    TerrainHeightField heightField{};
+    std::map<TileKey, Tile> tiles{};
+    /** World-space box of the chunk window, block faces included. */
+    glm::vec3 chunkAreaMin{0.0f};
+    glm::vec3 chunkAreaMax{0.0f};
+};
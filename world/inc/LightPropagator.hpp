@@ -2,13 +2,13 @@
 
 #include <vector>
 #include <queue>
-#include <unordered_map>
 #include <glm/vec3.hpp>
+#include "ChunkHalo.hpp"
 #include "VoxelTypes.hpp"
 
 class LightPropagator {
    public:
-    LightPropagator(int chunkSize, float attenuationFactor);
+    explicit LightPropagator(float attenuationFactor);
 
     LightPropagator(const LightPropagator&) = delete;
     LightPropagator& operator=(const LightPropagator&) = delete;
@@ -18,21 +18,19 @@ class LightPropagator {
     std::vector<float> computeLightMask(
         const VoxelTypes::VoxelGrid3D& originalVoxelGrid,
         const std::vector<glm::ivec3>& torchPositions,
-        const VoxelTypes::NeighborVoxelsMap& neighborsSurroundingCubes);
+        const ChunkHalo& neighborHalo);
 
    private:
-    int originalSize{0};
-    int paddedSize{0};
     float attenuation{0.f};
 
-    VoxelTypes::VoxelGrid3D paddedVoxels;
-    VoxelTypes::LightGrid3D paddedLight;
+    VoxelTypes::PaddedVoxelGrid3D paddedVoxels;
+    VoxelTypes::PaddedLightGrid3D paddedLight;
     std::queue<glm::ivec3> bfsQueue;
 
     void clearPaddedGrids();
     void emplaceChunkIntoPaddedGrid(const VoxelTypes::VoxelGrid3D& original);
-    void insertNeighborsSurroundingCubes(
-        const VoxelTypes::NeighborVoxelsMap& halo);
+    void insertNeighborHalo(const ChunkHalo& halo);
+    void insertHaloCell(const glm::ivec3& paddedPos, CubeType type);
     void seedChunkInternalTorches(const std::vector<glm::ivec3>& torches);
     void runPropagation();
     void propagateToNeighbors(const glm::ivec3& position, float nextLightValue);
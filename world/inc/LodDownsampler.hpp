@@ -0,0 +1,22 @@
+#pragma once
+#include "ChunkHeightmap.hpp"
+#include "ChunkMesh.hpp"
+#include "VoxelTypes.hpp"
+
+/** Coarse copies of a chunk for the distant levels of detail. The chunk is
+ * cut into cells of scale^3 blocks, aligned to the chunk and so to the
+ * world. A cell is solid when at least half its blocks are, or when it
+ * holds the top of at least half its columns, so that thin surfaces such as
+ * a canopy of leaves survive. A solid cell takes the most common type of
+ * its highest solid layer, so hills keep the color of their surface rather
+ * than that of the dirt below it. Fluids count as empty. */
+namespace LodDownsampler {
+constexpr int scaleOf(LodLevel level) { return 1 << static_cast<int>(level); }
+
+/** A full-size grid in which every cell of the level's scale holds a single
+ * type, so ChunkFaceMasks and GreedyMesher mesh it as they are, with at
+ * most one quad per cell face. heightmap must describe grid. */
+VoxelTypes::VoxelGrid3D downsample(const VoxelTypes::VoxelGrid3D& grid,
+                                   const ChunkHeightmap& heightmap,
+                                   LodLevel level);
+} // namespace LodDownsampler
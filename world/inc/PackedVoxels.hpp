@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Cube.hpp"
+#include "VoxelTypes.hpp"
+
+/** Compact, read-only copy of a chunk voxel grid kept for evicted chunks.
+ * Block types are replaced by indices into a per-chunk palette; a column
+ * holding a single type is stored as one palette index, every other column
+ * as bit-packed indices using just enough bits for the palette size. */
+class PackedVoxels {
+   public:
+    explicit PackedVoxels(const VoxelTypes::VoxelGrid3D& grid);
+    PackedVoxels(const PackedVoxels&) = delete;
+    PackedVoxels& operator=(const PackedVoxels&) = delete;
+    PackedVoxels(PackedVoxels&&) noexcept = default;
+    PackedVoxels& operator=(PackedVoxels&&) noexcept = default;
+    ~PackedVoxels() = default;
+
+    VoxelTypes::VoxelGrid3D unpack() const;
+    /** Heap and inline bytes held by this object. */
+    std::size_t getResidentBytes() const;
+
+   private:
+    using Word = std::uint64_t;
+    static constexpr int WORD_BITS{64};
+    /** Set on a column entry whose column holds a single palette index. */
+    static constexpr std::uint16_t UNIFORM_COLUMN{0x8000};
+
+    void buildPalette(const VoxelTypes::VoxelGrid3D& grid);
+    void packColumns(const VoxelTypes::VoxelGrid3D& grid);
+    void writeIndex(std::size_t bitOffset, unsigned index);
+    unsigned readIndex(std::size_t bitOffset) const;
+    std::size_t columnBitOffset(std::uint16_t packedColumn) const;
+
+    int bitsPerIndex{0};
+    std::vector<CubeType> palette{};
+    /** One entry per (x, z) column: the palette index of a uniform column
+     * tagged with UNIFORM_COLUMN, or the slot of its bit-packed run. */
+    std::vector<std::uint16_t> columnEntries{};
+    std::vector<Word> packedIndices{};
+};
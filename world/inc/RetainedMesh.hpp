@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ChunkFaceMasks.hpp"
+#include "ChunkHeightmap.hpp"
+#include "ChunkMesh.hpp"
+#include "CpuWaterMesh.hpp"
+#include "CubeData.hpp"
+
+/** The CPU copy of everything a chunk has uploaded, kept in step with each
+ * applied rebuild. It is enough to draw the chunk again with uploads alone,
+ * so an evicted chunk that comes back into the window is neither meshed nor
+ * lit again. */
+struct RetainedMesh {
+    /** Edit version of the chunk that the copy was built from, 0 before the
+     * first rebuild. */
+    std::uint64_t version{0};
+    /** What the last rebuild was built with, filled in on release. */
+    MeshingMode meshingMode{MeshingMode::INSTANCED_CUBES};
+    LodLevel lodLevel{LodLevel::FULL};
+    ChunkFaceMasks::FaceSet openBorderFaces{0};
+    /** Sides that had a loaded neighbor on release. The border faces there
+     * were hidden against it. */
+    ChunkFaceMasks::FaceSet loadedNeighbors{0};
+    ChunkMesh mesh{};
+    /** Empty while no light reaches the chunk, which is most of the time. */
+    std::vector<float> lightVolume{};
+    CpuWaterMesh waterMesh{};
+    ChunkHeightmap heightmap{};
+
+    /** Takes in an applied rebuild. A section rebuild replaces just the
+     * instances of its sections. */
+    void apply(CubeData&& data);
+    /** Drops the spare capacity of every buffer. */
+    void compact();
+    std::size_t getResidentBytes() const;
+};
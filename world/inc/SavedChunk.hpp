@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+#include "BlockStateTable.hpp"
+#include "Cube.hpp"
+#include "PackedVoxels.hpp"
+#include "VoxelTypes.hpp"
+
+/** What World keeps for an evicted chunk the player has edited. Terrain and
+ * trees regenerate from the chunk coordinates, so normally only the edited
+ * voxels are stored and replayed over a fresh chunk on restore. A chunk whose
+ * edits would take more room than its packed grid is kept as PackedVoxels.
+ * Either way the block states of the chunk are kept alongside. */
+class SavedChunk {
+   public:
+    /** One edited voxel in chunk-local coordinates. */
+    struct VoxelEdit {
+        std::uint8_t x{0};
+        std::uint8_t y{0};
+        std::uint8_t z{0};
+        CubeType type{CubeType::NONE};
+    };
+
+    SavedChunk(const VoxelTypes::VoxelEditsMap& edits,
+               BlockStateTable blockStates);
+    SavedChunk(PackedVoxels&& packedVoxels, BlockStateTable blockStates);
+    SavedChunk(const SavedChunk&) = delete;
+    SavedChunk& operator=(const SavedChunk&) = delete;
+    SavedChunk(SavedChunk&&) noexcept = default;
+    SavedChunk& operator=(SavedChunk&&) noexcept = default;
+    ~SavedChunk() = default;
+
+    /** Null when the chunk was saved as a packed grid. */
+    const std::vector<VoxelEdit>* getEdits() const;
+    /** Null when the chunk was saved as a list of edits. */
+    const PackedVoxels* getPackedVoxels() const;
+    inline const BlockStateTable& getBlockStates() const {
+        return blockStates;
+    }
+    std::size_t getResidentBytes() const;
+
+   private:
+    std::variant<std::vector<VoxelEdit>, PackedVoxels> contents;
+    BlockStateTable blockStates;
+};
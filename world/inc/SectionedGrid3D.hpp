@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <glm/vec3.hpp>
+
+/** Dimension^3 grid split into SECTION_SIZE^3 sections. A section holding a
+ * single value keeps only that value; its cells are allocated on the first
+ * write of a different value and released again by compact(). Inside a
+ * section cells are laid out x-major, then z, with y innermost, so a section
+ * column is one contiguous run. */
+template <typename T, int Dimension>
+class SectionedGrid3D {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SectionedGrid3D cells are compared and copied by value");
+
+   public:
+    static constexpr int SECTION_SHIFT{4};
+    static constexpr int SECTION_SIZE{1 << SECTION_SHIFT};
+    static constexpr int SECTION_MASK{SECTION_SIZE - 1};
+    static constexpr int SECTION_VOLUME{SECTION_SIZE * SECTION_SIZE *
+                                        SECTION_SIZE};
+    /** Distance between neighboring cells of a section along z and x. */
+    static constexpr int SECTION_Z_STRIDE{SECTION_SIZE};
+    static constexpr int SECTION_X_STRIDE{SECTION_SIZE * SECTION_SIZE};
+    static constexpr int SECTIONS_PER_AXIS{Dimension / SECTION_SIZE};
+    static constexpr int SECTION_COUNT{SECTIONS_PER_AXIS * SECTIONS_PER_AXIS *
+                                       SECTIONS_PER_AXIS};
+    static_assert(Dimension > 0 and Dimension % SECTION_SIZE == 0,
+                  "grid dimension must be a multiple of the section size");
+
+    explicit SectionedGrid3D(T fillValue = T{})
+        : sections(static_cast<std::size_t>(SECTIONS_PER_AXIS) *
+                       SECTIONS_PER_AXIS * SECTIONS_PER_AXIS,
+                   Section{fillValue, {}}) {}
+
+    static constexpr int getDimension() { return Dimension; }
+
+    inline T operator()(int x, int y, int z) const {
+        const auto& section = sectionAt(x, y, z);
+        if (section.cells.empty()) {
+            return section.uniformValue;
+        }
+        return section.cells[cellIndexOf(x, y, z)];
+    }
+    inline T operator[](const glm::ivec3& pos) const {
+        return (*this)(pos.x, pos.y, pos.z);
+    }
+
+    void set(int x, int y, int z, T value) {
+        auto& section = sectionAt(x, y, z);
+        if (section.cells.empty()) {
+            if (value == section.uniformValue) {
+                return;
+            }
+            section.cells.assign(SECTION_VOLUME, section.uniformValue);
+        }
+        section.cells[cellIndexOf(x, y, z)] = value;
+    }
+    inline void set(const glm::ivec3& pos, T value) {
+        set(pos.x, pos.y, pos.z, value);
+    }
+
+    /** True when the section containing pos holds a single value. */
+    inline bool isUniformSectionAt(const glm::ivec3& pos) const {
+        return sectionAt(pos.x, pos.y, pos.z).cells.empty();
+    }
+
+    /** True when every section holds value alone. Sections left uniform
+     * by writes count only once compact() has collapsed them. */
+    bool isUniform(T value) const {
+        return std::all_of(sections.cbegin(), sections.cend(),
+                           [value](const Section& section) {
+                               return section.cells.empty() and
+                                      section.uniformValue == value;
+                           });
+    }
+
+    /** The SECTION_SIZE cells of the section column containing pos, or
+     * nullptr when that section is uniform. */
+    inline const T* sectionColumnAt(const glm::ivec3& pos) const {
+        const auto& section = sectionAt(pos.x, pos.y, pos.z);
+        if (section.cells.empty()) {
+            return nullptr;
+        }
+        return &section.cells[cellIndexOf(pos.x, 0, pos.z)];
+    }
+
+    void readColumn(int x, int z, T* out) const {
+        for (int y = 0; y < Dimension; y += SECTION_SIZE, out += SECTION_SIZE) {
+            if (const auto* run = sectionColumnAt({x, y, z})) {
+                std::copy_n(run, SECTION_SIZE, out);
+            } else {
+                std::fill_n(out, SECTION_SIZE, sectionAt(x, y, z).uniformValue);
+            }
+        }
+    }
+
+    void writeColumn(int x, int z, const T* values) {
+        for (int y = 0; y < Dimension;
+             y += SECTION_SIZE, values += SECTION_SIZE) {
+            auto& section = sectionAt(x, y, z);
+            if (section.cells.empty()) {
+                if (std::all_of(values, values + SECTION_SIZE,
+                                [&section](T value) {
+                                    return value == section.uniformValue;
+                                })) {
+                    continue;
+                }
+                section.cells.assign(SECTION_VOLUME, section.uniformValue);
+            }
+            std::copy_n(values, SECTION_SIZE,
+                        &section.cells[cellIndexOf(x, 0, z)]);
+        }
+    }
+
+    /** Sections are numbered x-major, then z, with y innermost, like the
+     * cells inside them. */
+    static inline std::size_t sectionIndexOf(int x, int y, int z) {
+        return (static_cast<std::size_t>(x >> SECTION_SHIFT) *
+                    SECTIONS_PER_AXIS +
+                (z >> SECTION_SHIFT)) *
+                   SECTIONS_PER_AXIS +
+               (y >> SECTION_SHIFT);
+    }
+
+    /** Collapses sections whose cells all hold the same value. */
+    void compact() {
+        for (auto& section : sections) {
+            if (section.cells.empty()) {
+                continue;
+            }
+            const auto first = section.cells.front();
+            if (std::all_of(section.cells.cbegin(), section.cells.cend(),
+                            [first](T value) { return value == first; })) {
+                section.uniformValue = first;
+                section.cells.clear();
+                section.cells.shrink_to_fit();
+            }
+        }
+    }
+
+   private:
+    struct Section {
+        T uniformValue{};
+        std::vector<T> cells{};
+    };
+
+    static inline std::size_t cellIndexOf(int x, int y, int z) {
+        const auto localX = static_cast<std::size_t>(x & SECTION_MASK);
+        const auto localZ = static_cast<std::size_t>(z & SECTION_MASK);
+        return (((localX << SECTION_SHIFT) + localZ) << SECTION_SHIFT) +
+               (y & SECTION_MASK);
+    }
+    inline Section& sectionAt(int x, int y, int z) {
+        return sections[sectionIndexOf(x, y, z)];
+    }
+    inline const Section& sectionAt(int x, int y, int z) const {
+        return sections[sectionIndexOf(x, y, z)];
+    }
+
+    std::vector<Section> sections{};
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "FastNoiseLite.h"
+#include "Cube.hpp"
+
+/** The terrain surface the world is generated from: the world y of the top
+ * block of every column, straight from 2D noise. Cheap to sample anywhere,
+ * whether the chunks there are loaded or not. */
+class TerrainHeightField {
+   public:
+    /** World y of the water surface generated over low terrain. */
+    static constexpr int SEA_LEVEL{14};
+
+    TerrainHeightField();
+
+    /** World y of the top block of column (worldX, worldZ). */
+    int heightAt(int worldX, int worldZ) const;
+    /** The block a column is filled with at world y, up to its height. */
+    static CubeType blockTypeAt(int worldY);
+
+   private:
+    FastNoiseLite noise{};
+};
@@ -1,27 +1,28 @@
 #pragma once
 #include <unordered_set>
 #include <functional>
+#include <random>
 #include <glm/vec3.hpp>
 #include "Cube.hpp"
 #include "ChunkCoord.hpp"
+#include "ChunkHeightmap.hpp"
 #include "VoxelTypes.hpp"
 
 class TreeGenerator {
    public:
-    using CubeCreator = std::function<void(const glm::ivec3&, CubeType)>;
-    explicit TreeGenerator(int chunkSize);
+    /** Tree placement is seeded from the chunk coordinates, so the same
+     * chunk always grows the same trees. */
+    explicit TreeGenerator(const ChunkCoord& chunkCoord);
     ~TreeGenerator() = default;
     TreeGenerator(const TreeGenerator&) = delete;
     TreeGenerator(TreeGenerator&&) noexcept = default;
     TreeGenerator& operator=(const TreeGenerator&) = delete;
     TreeGenerator& operator=(TreeGenerator&&) noexcept = default;
-    void generateTrees(VoxelTypes::VoxelGrid3D& voxelGrid);
-
-    void reapplyTrunks(float initialCubeX, float initialCubeZ,
-                       const CubeCreator& createCubeCallback) const;
-
-    void reapplyCrowns(float initialCubeX, float initialCubeZ,
-                       const CubeCreator& createCubeCallback) const;
+    /** Grows trees on the surface given by heightmap. */
+    void generateTrees(VoxelTypes::VoxelGrid3D& voxelGrid,
+                       const ChunkHeightmap& heightmap);
+    /** For chunks restored from a grid that already contains their trees. */
+    void markTreesGenerated();
 
     void removeTreeCubeAt(const glm::ivec3& localPos);
 
@@ -29,17 +30,19 @@ class TreeGenerator {
     using Trunk = std::unordered_map<
         std::pair<int, int>, int,
         std::function<std::size_t(const std::pair<int, int>&)>>;
-    int findHighestFilledVoxelY(const VoxelTypes::VoxelGrid3D& voxelGrid, int x,
-                                int z) const;
     void placeTreeTrunkAt(int x, int highestY, int z,
                           VoxelTypes::VoxelGrid3D& voxelGrid);
-    void generateNewTreeTrunks(VoxelTypes::VoxelGrid3D& voxelGrid);
+    void generateNewTreeTrunks(VoxelTypes::VoxelGrid3D& voxelGrid,
+                               const ChunkHeightmap& heightmap);
     void generateCrownForTrunk(int colX, int colZ, int trunkTopY,
                                VoxelTypes::VoxelGrid3D& voxelGrid);
     void generateCrownsForTrunks(const Trunk& trunkColumns,
                                  VoxelTypes::VoxelGrid3D& voxelGrid);
     Trunk buildTrunksMapping() const;
-    int chunkSize{};
+    std::mt19937 random;
+    /** World y of the chunk's lowest layer of voxels. */
+    int chunkOriginY{0};
     std::unordered_set<glm::ivec3, PositionXYZHash> trunkPositions{};
     std::unordered_set<glm::ivec3, PositionXYZHash> crownPositions{};
+    bool treesGenerated{false};
 };
\ No newline at end of file
@@ -2,11 +2,22 @@
 #include <unordered_map>
 #include <glm/vec3.hpp>
 #include "ChunkCoord.hpp"
+#include "ChunkGeometry.hpp"
 #include "Cube.hpp"
+#include "Grid3D.hpp"
+#include "SectionedGrid3D.hpp"
 
 namespace VoxelTypes {
-using LightGrid3D = std::vector<std::vector<std::vector<float>>>;
-using VoxelGrid3D = std::vector<std::vector<std::vector<CubeType>>>;
-using NeighborVoxelsMap =
-    std::unordered_map<glm::ivec3, CubeType, PositionXYZHash>;
+/** A chunk plus its one-voxel neighbor halo, as used by light propagation. */
+using PaddedLightGrid3D = Grid3D<float, ChunkGeometry::PADDED_CHUNK_SIZE>;
+using PaddedVoxelGrid3D = Grid3D<CubeType, ChunkGeometry::PADDED_CHUNK_SIZE>;
+using VoxelGrid3D = SectionedGrid3D<CubeType, ChunkGeometry::CHUNK_SIZE>;
+/** Player edits of one chunk: local position to the block placed there. */
+using VoxelEditsMap = std::unordered_map<glm::ivec3, CubeType, PositionXYZHash>;
+/** One cell of a bulk edit, in chunk-local coordinates. */
+struct VoxelWrite {
+    glm::ivec3 localPos{};
+    CubeType type{CubeType::NONE};
+    BlockState state{0};
+};
 } // namespace VoxelTypes
\ No newline at end of file
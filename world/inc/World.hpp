@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <optional>
 #include <unordered_map>
@@ -9,10 +10,15 @@
 #include "CpuChunk.hpp"
 #include "Shader.hpp"
 #include "Frustum.hpp"
+#include "BlockTemplate.hpp"
 #include "ChunkCoord.hpp"
 #include "Camera.hpp"
 #include "ChunkLoader.hpp"
+#include "ChunkMeshCache.hpp"
 #include "ChunkUpdater.hpp"
+#include "ChunkTable.hpp"
+#include "ChunkWindowIndex.hpp"
+#include "HorizonTiles.hpp"
 #include "VoxelTypes.hpp"
 
 class World {
@@ -27,42 +33,126 @@ class World {
     bool addCubeFromRaycast(const Camera& camera, float maxDistance,
                             CubeType type);
     bool removeCubeFromRaycast(const Camera& camera, float maxDistance);
+    /** Bulk edits of loaded chunks; box bounds are inclusive world
+     * positions. Every touched chunk is written under one lock and rebuilt
+     * once; neighbors of chunks whose light sources changed, or whose
+     * border cells changed, are marked once. Each returns the number of
+     * blocks changed. */
+    std::size_t fillBox(const glm::ivec3& min, const glm::ivec3& max,
+                        CubeType type);
+    std::size_t fillHollowSphere(const glm::ivec3& center, int radius,
+                                 CubeType type);
+    std::size_t replaceInBox(const glm::ivec3& min, const glm::ivec3& max,
+                             CubeType from, CubeType to);
+    std::size_t pasteTemplate(const BlockTemplate& stamp,
+                              const glm::ivec3& origin);
+    BlockTemplate copyTemplate(const glm::ivec3& min,
+                               const glm::ivec3& max) const;
     void updateLoadedChunks();
-    void performFrustumCulling(const Frustum& frustum);
+    /** The horizon is culled against its own, deeper frustum. */
+    void performFrustumCulling(const Frustum& frustum,
+                               const Frustum& horizonFrustum);
     void renderByType(Shader& shader, CubeType type);
     void renderWaterMeshes(Shader& shader);
+    /** The heightfield terrain past the loaded chunks. */
+    void renderHorizon(Shader& shader);
+    /** Remeshes every loaded chunk in the new mode. */
+    void setMeshingMode(MeshingMode mode);
+    inline MeshingMode getMeshingMode() const { return meshingMode; }
+    /** Chunks farther than these distances from the camera, in blocks, are
+     * meshed at half and at quarter detail. */
+    void setLodRingDistances(float halfDetail, float quarterDetail);
+    /** Bytes kept for the meshes of evicted chunks, which are drawn again
+     * without a rebuild when they come back into the window. */
+    void setMeshCacheBudget(std::size_t bytes);
+    /** Triangles drawn by the chunks that survived frustum culling. */
+    std::size_t countRenderedTriangles();
     RenderableChunk* getChunk(const ChunkCoord& coord) const;
     CubeType getCubeTypeAtPosition(const glm::ivec3& position) const;
+    Voxel getVoxelAtPosition(const glm::ivec3& position) const;
+    /** False when no loaded stateful block is at position. */
+    bool setBlockStateAtPosition(const glm::ivec3& position, BlockState state);
+    /** Occupancy queries; unloaded chunks read as empty. */
+    bool isSolidAt(const glm::ivec3& position) const;
+    std::optional<int> findLowestSolidY(int worldX, int worldZ, int minY,
+                                        int maxY) const;
+    /** Chunks whose top lies in range are answered by their heightmap. */
+    std::optional<int> findHighestSolidY(int worldX, int worldZ, int minY,
+                                         int maxY) const;
 
    private:
-    VoxelTypes::NeighborVoxelsMap gatherEdgeVoxelsFor(
-        const ChunkCoord& centerCoord);
     void notifyNeighborChunks(const ChunkCoord& centerCoord);
+    /** Marks the border of the chunks sharing a face with centerCoord for a
+     * remesh, after it was loaded or evicted, except those drawn with a kept
+     * mesh that was built against it already. */
+    void notifyFaceNeighbors(const ChunkCoord& centerCoord);
+    /** Marks the border of the face neighbors next to an edit of the local
+     * box [localMin, localMax] of centerCoord. */
+    void notifyBorderNeighbors(const ChunkCoord& centerCoord,
+                               const glm::ivec3& localMin,
+                               const glm::ivec3& localMax);
+    /** Inside the chunk window, where the horizon leaves off. */
+    bool isWithinDrawDistance(const ChunkCoord& coord) const;
+    /** The level of detail of chunk at its distance from the camera. */
+    LodLevel chooseLodLevel(const RenderableChunk& chunk) const;
+    /** Moves chunks between levels as the camera moves, and marks the
+     * full-detail neighbors of the ones entering or leaving full detail. */
+    void updateLodLevels();
+    /** Sides of chunk facing a loaded neighbor at another level of detail. */
+    ChunkFaceMasks::FaceSet findSeamFaces(const ChunkCoord& coord,
+                                          const RenderableChunk& chunk) const;
+    /** Sides of coord with a loaded neighbor. */
+    ChunkFaceMasks::FaceSet findLoadedNeighbors(const ChunkCoord& coord) const;
+    /** Writes rule(worldPos, currentType) into every cell of the box where
+     * it returns a type, batching the writes per chunk. */
+    template <typename CellRule>
+    std::size_t editRegion(const glm::ivec3& min, const glm::ivec3& max,
+                           CellRule&& rule);
     void loadInitialChunks();
     bool updateCameraChunk(const ChunkCoord& currentCamCoord);
-    std::unordered_set<ChunkCoord, PositionXYHash> getLoadedChunkKeys();
+    std::unordered_set<ChunkCoord, ChunkCoordHash> getLoadedChunkKeys();
     void mergeNewChunks(Coord::CpuChunksMap& newChunks);
     void reloadCurrentlyRelevantChunkGroup(const ChunkCoord& currentCamCoord);
     void runUpdatePerChunk();
-    void restoreSavedChunks(const ChunkWindow& window);
+    /** Moves the saves of the evicted chunks inside window out of their
+     * slots, for the loader task to restore off the main thread. */
+    ChunkLoader::SavedChunks takeSavedChunks(const ChunkWindow& window);
     void evictOutOfRangeChunks(const ChunkWindow& window);
     void adjustLoadedChunks(const ChunkCoord& currentCamCoord);
 
-    void restoreSavedChunk(const ChunkCoord& coord,
-                           Coord::CpuChunksMap::iterator& it);
-    bool shouldEvictLoadedChunk(const ChunkCoord& coord,
+    bool shouldEvictLoadedChunk(const ChunkCoord& coord, const ChunkSlot& slot,
                                 const ChunkWindow& window) const;
-    void evictLoadedChunk(const ChunkCoord& coord,
-                          Coord::RenderableChunksMap::iterator& it);
+    void evictLoadedChunk(const ChunkCoord& coord, ChunkSlot& slot);
+    /** Keeps the mesh of a chunk about to be evicted. Called for all of
+     * them before any is evicted, so that none is left modified by the
+     * eviction of its neighbors. */
+    void retainMesh(const ChunkCoord& coord, RenderableChunk& chunk);
+    /** Draws a chunk just loaded or restored with its kept mesh, if any,
+     * and marks it for a remesh only where its neighbors changed. */
+    void adoptRetainedMesh(const ChunkCoord& coord, RenderableChunk& chunk);
     void injectNeighborsToModifiedChunks();
 
     std::mutex loadedChunksMutex{};
-    Coord::RenderableChunksMap loadedChunks{};
-    Coord::CpuChunksMap savedChunks{};
-    Coord::ChunkUpdatersMap chunkUpdaters{};
+    /** Loaded chunks with their updaters, and saves of evicted ones. */
+    ChunkTable chunks{};
 
-    ChunkCoord lastCameraChunk{-1000, -1000};
+    ChunkCoord lastCameraChunk{-1000, -1000, -1000};
+    /** The camera changed chunk since the loader task last started. */
+    bool isWindowLoadPending{false};
     int renderDistance{8};
+    /** Layers loaded above and below the camera's own. */
+    int verticalRenderDistance{1};
+    /** O(1) chunk lookup around the camera for physics and raycasts. */
+    ChunkWindowIndex windowIndex{chunks, renderDistance,
+                                 verticalRenderDistance};
+    /** Scratch halo reused for every modified chunk. */
+    ChunkHalo neighborHalo{};
     glm::vec3 cameraPosition{};
     std::unique_ptr<ChunkLoader> chunkLoader{};
+    MeshingMode meshingMode{MeshingMode::INSTANCED_CUBES};
+    /** Distances from the camera past which chunks drop to half, then to
+     * quarter detail, in blocks. */
+    std::array<float, 2> lodRingDistances{160.0f, 320.0f};
+    HorizonTiles horizon{};
+    ChunkMeshCache meshCache{};
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "BlockStateTable.hpp"
+#include <algorithm>
+
+namespace {
+template <typename Entries>
+auto findEntry(Entries& entries, std::uint16_t cell) {
+    return std::lower_bound(
+        entries.begin(), entries.end(), cell,
+        [](const auto& entry, std::uint16_t key) { return entry.cell < key; });
+}
+} // namespace
+
+BlockState BlockStateTable::at(const glm::ivec3& localPos) const {
+    if (sections.empty()) {
+        return 0;
+    }
+    const auto& entries = sections[sectionIndexOf(localPos)];
+    const auto cell = cellIndexOf(localPos);
+    const auto it = findEntry(entries, cell);
+    return it != entries.end() and it->cell == cell ? it->state : 0;
+}
+
+void BlockStateTable::set(const glm::ivec3& localPos, BlockState state) {
+    if (sections.empty()) {
+        if (state == 0) {
+            return;
+        }
+        sections.resize(SECTION_COUNT);
+    }
+    auto& entries = sections[sectionIndexOf(localPos)];
+    const auto cell = cellIndexOf(localPos);
+    const auto it = findEntry(entries, cell);
+    const bool found{it != entries.end() and it->cell == cell};
+    if (state != 0) {
+        if (found) {
+            it->state = state;
+        } else {
+            entries.insert(it, Entry{cell, state});
+            ++stateCount;
+        }
+        return;
+    }
+    if (not found) {
+        return;
+    }
+    entries.erase(it);
+    if (entries.empty()) {
+        entries.shrink_to_fit();
+    }
+    if (--stateCount == 0) {
+        sections.clear();
+        sections.shrink_to_fit();
+    }
+}
+
+std::size_t BlockStateTable::getResidentBytes() const {
+    std::size_t bytes{sizeof(*this) +
+                      sections.capacity() * sizeof(std::vector<Entry>)};
+    for (const auto& entries : sections) {
+        bytes += entries.capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+std::size_t BlockStateTable::sectionIndexOf(const glm::ivec3& localPos) {
+    return (static_cast<std::size_t>(localPos.x >> SECTION_SHIFT) *
+                SECTIONS_PER_AXIS +
+            (localPos.z >> SECTION_SHIFT)) *
+               SECTIONS_PER_AXIS +
+           (localPos.y >> SECTION_SHIFT);
+}
+
+std::uint16_t BlockStateTable::cellIndexOf(const glm::ivec3& localPos) {
+    const auto localX = localPos.x & SECTION_MASK;
+    const auto localZ = localPos.z & SECTION_MASK;
+    return static_cast<std::uint16_t>(
+        (((localX << SECTION_SHIFT) + localZ) << SECTION_SHIFT) +
+        (localPos.y & SECTION_MASK));
+}
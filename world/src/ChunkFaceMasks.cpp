@@ -0,0 +1,149 @@
+#include "ChunkFaceMasks.hpp"
+#include <algorithm>
+#include <bit>
+#include "BlockRegistry.hpp"
+
+namespace {
+constexpr int SECTION_SIZE{VoxelTypes::VoxelGrid3D::SECTION_SIZE};
+constexpr int SECTIONS_PER_AXIS{VoxelTypes::VoxelGrid3D::SECTIONS_PER_AXIS};
+using ColumnMask = ChunkFaceMasks::ColumnMask;
+constexpr ColumnMask SECTION_BITS{(ColumnMask{1} << SECTION_SIZE) - 1};
+} // namespace
+
+void ChunkFaceMasks::build(const VoxelTypes::VoxelGrid3D& grid) {
+    for (auto& side : border) {
+        side.fill(0);
+    }
+    buildColumnMasks(grid, {});
+    buildFaceMasks({});
+}
+
+void ChunkFaceMasks::build(const VoxelTypes::VoxelGrid3D& grid,
+                           const ChunkHalo& halo, FaceSet openFaces) {
+    buildBorderMasks(halo, openFaces);
+    buildColumnMasks(grid, {});
+    buildFaceMasks({});
+}
+
+void ChunkFaceMasks::build(const VoxelTypes::VoxelGrid3D& grid,
+                           const ChunkHalo& halo, FaceSet openFaces,
+                           std::uint64_t sections) {
+    buildBorderMasks(halo, openFaces);
+    // Sections stacked in one column of sections share their columns.
+    std::array<bool, SECTIONS_PER_AXIS * SECTIONS_PER_AXIS> footprint{};
+    for (; sections != 0; sections &= sections - 1) {
+        footprint[std::countr_zero(sections) / SECTIONS_PER_AXIS] = true;
+    }
+    for (int sectionX = 0; sectionX < SECTIONS_PER_AXIS; ++sectionX) {
+        for (int sectionZ = 0; sectionZ < SECTIONS_PER_AXIS; ++sectionZ) {
+            if (not footprint[sectionX * SECTIONS_PER_AXIS + sectionZ]) {
+                continue;
+            }
+            const ColumnRange range{sectionX * SECTION_SIZE,
+                                    (sectionX + 1) * SECTION_SIZE,
+                                    sectionZ * SECTION_SIZE,
+                                    (sectionZ + 1) * SECTION_SIZE};
+            // The side faces also read the columns just around the range.
+            buildColumnMasks(grid, {std::max(range.beginX - 1, 0),
+                                    std::min(range.endX + 1, CHUNK_SIZE),
+                                    std::max(range.beginZ - 1, 0),
+                                    std::min(range.endZ + 1, CHUNK_SIZE)});
+            buildFaceMasks(range);
+        }
+    }
+}
+
+void ChunkFaceMasks::buildColumnMasks(const VoxelTypes::VoxelGrid3D& grid,
+                                      const ColumnRange& range) {
+    for (int x = range.beginX; x < range.endX; ++x) {
+        for (int z = range.beginZ; z < range.endZ; ++z) {
+            ColumnMask solidColumn{0};
+            ColumnMask opaqueColumn{0};
+            for (int sectionY = 0; sectionY < CHUNK_SIZE;
+                 sectionY += SECTION_SIZE) {
+                const auto* run = grid.sectionColumnAt({x, sectionY, z});
+                if (not run) {
+                    // A uniform section sets or clears its whole run at once.
+                    const auto type = grid(x, sectionY, z);
+                    const ColumnMask bits{SECTION_BITS << sectionY};
+                    solidColumn |= BlockRegistry::isSolid(type) ? bits : 0;
+                    opaqueColumn |= BlockRegistry::isOpaque(type) ? bits : 0;
+                    continue;
+                }
+                for (int localY = 0; localY < SECTION_SIZE; ++localY) {
+                    const auto bit = sectionY + localY;
+                    const auto type = run[localY];
+                    solidColumn |= ColumnMask{BlockRegistry::isSolid(type)}
+                                   << bit;
+                    opaqueColumn |= ColumnMask{BlockRegistry::isOpaque(type)}
+                                    << bit;
+                }
+            }
+            solid[indexOf(x, z)] = solidColumn;
+            opaque[indexOf(x, z)] = opaqueColumn;
+        }
+    }
+}
+
+void ChunkFaceMasks::buildBorderMasks(const ChunkHalo& halo,
+                                      FaceSet openFaces) {
+    constexpr int LAST{ChunkHalo::PADDED_SIZE - 1};
+    const auto opaqueBits = [](const CubeType* cells) {
+        ColumnMask bits{0};
+        for (int i = 0; i < CHUNK_SIZE; ++i) {
+            bits |= ColumnMask{BlockRegistry::isOpaque(cells[i])} << i;
+        }
+        return bits;
+    };
+    const auto* below = halo.layer(ChunkHalo::BELOW);
+    const auto* above = halo.layer(ChunkHalo::ABOVE);
+    for (int i = 0; i < CHUNK_SIZE; ++i) {
+        // Padded coordinates: the chunk spans [1, CHUNK_SIZE].
+        border[POS_X][i] = opaqueBits(halo.column(LAST, i + 1));
+        border[NEG_X][i] = opaqueBits(halo.column(0, i + 1));
+        border[POS_Z][i] = opaqueBits(halo.column(i + 1, LAST));
+        border[NEG_Z][i] = opaqueBits(halo.column(i + 1, 0));
+        // The layers are x-major, so the cells of one x are contiguous.
+        const auto layerRow = ChunkHalo::layerIndexOf(i + 1, 1);
+        border[POS_Y][i] = opaqueBits(above + layerRow);
+        border[NEG_Y][i] = opaqueBits(below + layerRow);
+    }
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        if ((openFaces >> face) & 1) {
+            border[face].fill(0);
+        }
+    }
+}
+
+void ChunkFaceMasks::buildFaceMasks(const ColumnRange& range) {
+    constexpr int LAST{CHUNK_SIZE - 1};
+    for (int x = range.beginX; x < range.endX; ++x) {
+        for (int z = range.beginZ; z < range.endZ; ++z) {
+            const auto index = indexOf(x, z);
+            const auto column = solid[index];
+            // Columns past the chunk border come from the neighbors.
+            const auto east =
+                x < LAST ? opaque[indexOf(x + 1, z)] : border[POS_X][z];
+            const auto west =
+                x > 0 ? opaque[indexOf(x - 1, z)] : border[NEG_X][z];
+            const auto south =
+                z < LAST ? opaque[indexOf(x, z + 1)] : border[POS_Z][x];
+            const auto north =
+                z > 0 ? opaque[indexOf(x, z - 1)] : border[NEG_Z][x];
+            const auto above = (border[POS_Y][x] >> z) & 1;
+            const auto below = (border[NEG_Y][x] >> z) & 1;
+            const auto up = (opaque[index] >> 1) | (above << LAST);
+            const auto down = (opaque[index] << 1) | below;
+            faces[POS_X][index] = column & ~east;
+            faces[NEG_X][index] = column & ~west;
+            faces[POS_Y][index] = column & ~up;
+            faces[NEG_Y][index] = column & ~down;
+            faces[POS_Z][index] = column & ~south;
+            faces[NEG_Z][index] = column & ~north;
+            exposed[index] =
+                faces[POS_X][index] | faces[NEG_X][index] |
+                faces[POS_Y][index] | faces[NEG_Y][index] |
+                faces[POS_Z][index] | faces[NEG_Z][index];
+        }
+    }
+}
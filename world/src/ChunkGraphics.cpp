@@ -1,10 +1,28 @@
 #include "ChunkGraphics.hpp"
+#include "BlockRegistry.hpp"
 #include "WaterSystem.hpp"
 #include "VertexData.hpp"
 #include <array>
+#include <bit>
 
 namespace {
-constexpr unsigned MATRIX_ATTR_COUNT = 4;
+constexpr unsigned INSTANCE_POSITION_ATTR = 3;
+constexpr unsigned INSTANCE_LIGHT_ATTR = 7;
+constexpr unsigned SURFACE_HEIGHTS_TEXTURE_UNIT = 14;
+/** Free slots a non-empty section gets past its instances when laid out,
+ * so that most edits fit without moving the other sections. */
+constexpr unsigned SECTION_SPARE_SLOTS{16};
+constexpr GLsizeiptr INSTANCE_BYTES{sizeof(glm::vec3)};
+
+/** Layout of glMultiDrawElementsIndirect commands. */
+struct DrawElementsIndirectCommand {
+    GLuint count{0};
+    GLuint instanceCount{0};
+    GLuint firstIndex{0};
+    GLint baseVertex{0};
+    GLuint baseInstance{0};
+};
+
 void initPositionVertexAttributes(unsigned int stride) {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
     glEnableVertexAttribArray(0);
@@ -24,15 +42,16 @@ void initNormalVertexAttributes(unsigned int stride) {
 } // namespace
 
 void ChunkGraphics::generateInstanceBuffersForCubeTypes() {
-    const std::array<CubeType, 6> types{CubeType::SAND,   CubeType::DIRT,
-                                        CubeType::GRASS,  CubeType::LOG,
-                                        CubeType::LEAVES, CubeType::TORCH};
-    for (auto type : types) {
-        unsigned cubeId{};
+    for (std::size_t id = 0; id < BlockRegistry::BLOCK_TYPE_COUNT; ++id) {
+        const auto type = static_cast<CubeType>(id);
+        if (not BlockRegistry::isSolid(type)) {
+            continue;
+        }
         unsigned lightSourceId{};
-        glGenBuffers(1, &cubeId);
+        auto& slots = instanceSlots[type];
+        glGenBuffers(1, &slots.buffer);
+        glGenBuffers(1, &slots.drawCommands);
         glGenBuffers(1, &lightSourceId);
-        instanceVBOs[type] = cubeId;
         instanceLightVBOs[type] = lightSourceId;
     }
 }
@@ -53,6 +72,32 @@ void ChunkGraphics::initializeTorchLightVolumeGLParams(int volumeDimension) {
     glBindTexture(GL_TEXTURE_3D, 0);
 }
 
+void ChunkGraphics::initializeSurfaceHeightsGLParams() {
+    constexpr int SIZE{ChunkHeightmap::CHUNK_SIZE};
+    glGenTextures(1, &surfaceHeightsTexture);
+    glBindTexture(GL_TEXTURE_2D, surfaceHeightsTexture);
+    // Integer textures are fetched exactly and cannot be filtered.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, SIZE, SIZE, 0, GL_RED_INTEGER,
+                 GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ChunkGraphics::initializeQuadGLParams() {
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glGenBuffers(1, &quadEBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+    const unsigned stride = sizeof(Vertex);
+    initPositionVertexAttributes(stride);
+    initTextureCoordVertexAttributes(stride);
+    initNormalVertexAttributes(stride);
+    glBindVertexArray(0);
+}
+
 void ChunkGraphics::initializeGL(unsigned vertexBufferObjects, unsigned cubeEbo,
                                  unsigned waterEbo, int volumeDimension) {
     regularCubeEBO = cubeEbo;
@@ -71,13 +116,143 @@ void ChunkGraphics::initializeGL(unsigned vertexBufferObjects, unsigned cubeEbo,
 
     generateInstanceBuffersForCubeTypes();
     initializeTorchLightVolumeGLParams(volumeDimension);
+    initializeSurfaceHeightsGLParams();
     glBindVertexArray(0);
+    initializeQuadGLParams();
 }
 
-void ChunkGraphics::updateInstanceData(
-    const std::unordered_map<CubeType, std::vector<glm::mat4>>& matricesData) {
-    instanceMatricesData = matricesData;
-    uploadInstanceBuffer();
+void ChunkGraphics::updateInstanceData(const ChunkMesh& mesh) {
+    static const ChunkMesh::SectionCounts NO_COUNTS{};
+    static const std::vector<glm::vec3> NO_POSITIONS{};
+    instanceTriangleCount = 0;
+    for (auto& [cubeType, slots] : instanceSlots) {
+        // A type missing from the mesh has no instances in its sections.
+        const auto counts = mesh.sectionInstanceCounts.find(cubeType);
+        const auto positions = mesh.instancePositions.find(cubeType);
+        const bool changed = writeSectionInstances(
+            slots, mesh.sections,
+            counts != mesh.sectionInstanceCounts.cend() ? counts->second
+                                                        : NO_COUNTS,
+            positions != mesh.instancePositions.cend() ? positions->second
+                                                       : NO_POSITIONS);
+        if (changed) {
+            updateDrawCommands(cubeType, slots);
+        }
+        instanceTriangleCount +=
+            slots.instanceCount * ChunkMesh::TRIANGLES_PER_CUBE;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool ChunkGraphics::writeSectionInstances(
+    InstanceSlots& slots, ChunkMesh::SectionMask sections,
+    const ChunkMesh::SectionCounts& counts,
+    const std::vector<glm::vec3>& positions) {
+    bool changed{false};
+    bool fits{true};
+    for (auto pending = sections; pending != 0; pending &= pending - 1) {
+        const auto section = std::countr_zero(pending);
+        changed |= counts[section] != slots.count[section];
+        fits = fits and counts[section] <= slots.capacity[section];
+    }
+    if (not fits) {
+        relayoutInstanceSlots(slots, sections, counts);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, slots.buffer);
+    // Positions hold the sections one after another, in section order.
+    const glm::vec3* sectionPositions = positions.data();
+    for (; sections != 0; sections &= sections - 1) {
+        const auto section = std::countr_zero(sections);
+        if (counts[section] > 0) {
+            glBufferSubData(GL_ARRAY_BUFFER,
+                            slots.first[section] * INSTANCE_BYTES,
+                            counts[section] * INSTANCE_BYTES,
+                            sectionPositions);
+        }
+        sectionPositions += counts[section];
+        slots.count[section] = counts[section];
+    }
+    return changed;
+}
+
+void ChunkGraphics::relayoutInstanceSlots(
+    InstanceSlots& slots, ChunkMesh::SectionMask sections,
+    const ChunkMesh::SectionCounts& counts) {
+    ChunkMesh::SectionCounts first{};
+    ChunkMesh::SectionCounts capacity{};
+    unsigned slotCount{0};
+    for (int section = 0; section < ChunkMesh::SECTION_COUNT; ++section) {
+        const bool rewritten{((sections >> section) & 1) != 0};
+        const auto needed = rewritten ? counts[section] : slots.count[section];
+        first[section] = slotCount;
+        capacity[section] = needed == 0 ? 0 : needed + SECTION_SPARE_SLOTS;
+        slotCount += capacity[section];
+    }
+
+    GLuint buffer{0};
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, slotCount * INSTANCE_BYTES, nullptr,
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, slots.buffer);
+    for (int section = 0; section < ChunkMesh::SECTION_COUNT; ++section) {
+        const bool rewritten{((sections >> section) & 1) != 0};
+        if (not rewritten and slots.count[section] > 0) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                slots.first[section] * INSTANCE_BYTES,
+                                first[section] * INSTANCE_BYTES,
+                                slots.count[section] * INSTANCE_BYTES);
+        }
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &slots.buffer);
+    slots.buffer = buffer;
+    slots.first = first;
+    slots.capacity = capacity;
+}
+
+void ChunkGraphics::updateDrawCommands(CubeType cubeType,
+                                       InstanceSlots& slots) {
+    const auto indexCount = static_cast<GLuint>(
+        WaterSystem::isWater(cubeType) ? waterIndices.size() : indices.size());
+    std::array<DrawElementsIndirectCommand, ChunkMesh::SECTION_COUNT>
+        commands{};
+    GLsizei commandCount{0};
+    slots.instanceCount = 0;
+    for (int section = 0; section < ChunkMesh::SECTION_COUNT; ++section) {
+        if (slots.count[section] > 0) {
+            commands[commandCount++] = {indexCount, slots.count[section], 0,
+                                        0, slots.first[section]};
+            slots.instanceCount += slots.count[section];
+        }
+    }
+    slots.commandCount = commandCount;
+    if (commandCount > 0) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, slots.drawCommands);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                     commandCount * sizeof(DrawElementsIndirectCommand),
+                     commands.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+}
+
+void ChunkGraphics::updateQuadData(const ChunkMesh& mesh) {
+    quadRanges = mesh.quadRanges;
+    quadTriangleCount = mesh.quadIndices.size() / 3;
+    if (mesh.quadIndices.empty()) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, mesh.quadVertices.size() * sizeof(Vertex),
+                 mesh.quadVertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // The element buffer binding belongs to the VAO.
+    glBindVertexArray(quadVAO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 mesh.quadIndices.size() * sizeof(unsigned),
+                 mesh.quadIndices.data(), GL_DYNAMIC_DRAW);
+    glBindVertexArray(0);
 }
 
 void ChunkGraphics::updateLightVolume(const std::vector<float>& volume,
@@ -90,71 +265,96 @@ void ChunkGraphics::updateLightVolume(const std::vector<float>& volume,
     glActiveTexture(GL_TEXTURE0);
 }
 
-void ChunkGraphics::uploadInstanceBuffer() {
-    for (auto& [cubeType, instanceMatrices] : instanceMatricesData) {
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBOs[cubeType]);
-        glBufferData(GL_ARRAY_BUFFER,
-                     instanceMatrices.size() * sizeof(glm::mat4),
-                     instanceMatrices.data(), GL_DYNAMIC_DRAW);
-    }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+void ChunkGraphics::clearLightVolume() {
+    glClearTexImage(lightVolumeTexture, 0, GL_RED, GL_FLOAT, nullptr);
+}
+
+void ChunkGraphics::updateSurfaceHeights(const ChunkHeightmap& heightmap) {
+    constexpr int SIZE{ChunkHeightmap::CHUNK_SIZE};
+    glBindTexture(GL_TEXTURE_2D, surfaceHeightsTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, SIZE, SIZE, GL_RED_INTEGER,
+                    GL_UNSIGNED_BYTE, heightmap.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ChunkGraphics::bindTextures() const {
+    glActiveTexture(GL_TEXTURE0 + 15);
+    glBindTexture(GL_TEXTURE_3D, lightVolumeTexture);
+    glActiveTexture(GL_TEXTURE0 + SURFACE_HEIGHTS_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, surfaceHeightsTexture);
+    glActiveTexture(GL_TEXTURE0);
 }
 
 void ChunkGraphics::bindInstanceAttributesForType(CubeType cubeType) const {
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBOs.at(cubeType));
-    for (unsigned attrIndex = 0; attrIndex < MATRIX_ATTR_COUNT; ++attrIndex) {
-        glVertexAttribPointer(3 + attrIndex, 4, GL_FLOAT, GL_FALSE,
-                              sizeof(glm::mat4),
-                              (void*)(attrIndex * sizeof(glm::vec4)));
-        glEnableVertexAttribArray(3 + attrIndex);
-        glVertexAttribDivisor(3 + attrIndex, 1);
-    }
-    const unsigned lightAttr = 3 + MATRIX_ATTR_COUNT;
+    glBindBuffer(GL_ARRAY_BUFFER, instanceSlots.at(cubeType).buffer);
+    glVertexAttribPointer(INSTANCE_POSITION_ATTR, 3, GL_FLOAT, GL_FALSE,
+                          sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(INSTANCE_POSITION_ATTR);
+    glVertexAttribDivisor(INSTANCE_POSITION_ATTR, 1);
     glBindBuffer(GL_ARRAY_BUFFER, instanceLightVBOs.at(cubeType));
-    glVertexAttribPointer(lightAttr, 1, GL_FLOAT, GL_FALSE, sizeof(float),
-                          (void*)0);
-    glEnableVertexAttribArray(lightAttr);
-    glVertexAttribDivisor(lightAttr, 1);
+    glVertexAttribPointer(INSTANCE_LIGHT_ATTR, 1, GL_FLOAT, GL_FALSE,
+                          sizeof(float), (void*)0);
+    glEnableVertexAttribArray(INSTANCE_LIGHT_ATTR);
+    glVertexAttribDivisor(INSTANCE_LIGHT_ATTR, 1);
 }
 
-void ChunkGraphics::drawElements(CubeType cubeType, unsigned amt) const {
+void ChunkGraphics::drawElements(CubeType cubeType,
+                                 GLsizei commandCount) const {
+    // One command per section; each starts at the section's first slot.
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER,
+                 instanceSlots.at(cubeType).drawCommands);
     if (WaterSystem::isWater(cubeType)) {
         glDepthMask(GL_FALSE);
         glDisable(GL_CULL_FACE);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, waterEBO);
-        glDrawElementsInstanced(GL_TRIANGLES,
-                                static_cast<GLsizei>(waterIndices.size()),
-                                GL_UNSIGNED_INT, nullptr, amt);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    commandCount, 0);
         glEnable(GL_CULL_FACE);
         glDepthMask(GL_TRUE);
     } else {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, regularCubeEBO);
-        glDrawElementsInstanced(GL_TRIANGLES,
-                                static_cast<GLsizei>(indices.size()),
-                                GL_UNSIGNED_INT, nullptr, amt);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                    commandCount, 0);
     }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void ChunkGraphics::drawQuads(CubeType cubeType) const {
+    const auto range = quadRanges.find(cubeType);
+    if (range == quadRanges.cend() or range->second.indexCount == 0) {
+        return;
+    }
+    glBindVertexArray(quadVAO);
+    // Quad vertices are already in world space: no instance offset.
+    glVertexAttrib3f(INSTANCE_POSITION_ATTR, 0.0f, 0.0f, 0.0f);
+    bindTextures();
+    glDrawElements(
+        GL_TRIANGLES, static_cast<GLsizei>(range->second.indexCount),
+        GL_UNSIGNED_INT,
+        (void*)(range->second.firstIndex * sizeof(unsigned)));
+    glBindVertexArray(0);
 }
 
 void ChunkGraphics::renderByType(CubeType cubeType) const {
-    const auto instanceMatrices = instanceMatricesData.find(cubeType);
-    if (instanceMatrices == instanceMatricesData.cend() or
-        instanceMatrices->second.empty()) {
+    drawQuads(cubeType);
+    const auto slots = instanceSlots.find(cubeType);
+    if (slots == instanceSlots.cend() or slots->second.commandCount == 0) {
         return;
     }
 
     glBindVertexArray(vertexArrayObjects);
     bindInstanceAttributesForType(cubeType);
-    glActiveTexture(GL_TEXTURE0 + 15);
-    glBindTexture(GL_TEXTURE_3D, lightVolumeTexture);
-    glActiveTexture(GL_TEXTURE0);
-    drawElements(cubeType,
-                 static_cast<unsigned>(instanceMatrices->second.size()));
+    bindTextures();
+    drawElements(cubeType, slots->second.commandCount);
     glBindVertexArray(0);
 }
 
 ChunkGraphics::~ChunkGraphics() {
-    for (auto& [_, buf] : instanceVBOs) {
-        glDeleteBuffers(1, &buf);
+    for (auto& [_, slots] : instanceSlots) {
+        glDeleteBuffers(1, &slots.buffer);
+        glDeleteBuffers(1, &slots.drawCommands);
     }
     for (auto& [_, buf] : instanceLightVBOs) {
         glDeleteBuffers(1, &buf);
@@ -162,7 +362,15 @@ ChunkGraphics::~ChunkGraphics() {
     if (lightVolumeTexture) {
         glDeleteTextures(1, &lightVolumeTexture);
     }
+    if (surfaceHeightsTexture) {
+        glDeleteTextures(1, &surfaceHeightsTexture);
+    }
     if (vertexArrayObjects) {
         glDeleteVertexArrays(1, &vertexArrayObjects);
     }
+    if (quadVAO) {
+        glDeleteVertexArrays(1, &quadVAO);
+        glDeleteBuffers(1, &quadVBO);
+        glDeleteBuffers(1, &quadEBO);
+    }
 }
@@ -2,13 +2,13 @@
 #include "VertexDataBuilder.hpp"
 #include "RenderableChunk.hpp"
 #include <glad/glad.h>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <future>
+#include <utility>
 
-ChunkLoader::ChunkLoader(int renderingDistance, int sizeOfChunk)
-    : vertices{createCubeVertexVector()},
-      renderDistance(renderingDistance),
-      chunkSize(sizeOfChunk) {
+ChunkLoader::ChunkLoader() : vertices{createCubeVertexVector()} {
     setupVertexBuffers();
 }
 
@@ -35,35 +35,61 @@ void ChunkLoader::setupVertexBuffers() {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
-std::unique_ptr<RenderableChunk> ChunkLoader::createChunk(int x, int z) {
-    auto cpuChunk = std::make_unique<CpuChunk>(chunkSize, x, z);
+std::unique_ptr<RenderableChunk> ChunkLoader::createChunk(
+    const ChunkCoord& coord) {
+    auto cpuChunk = std::make_unique<CpuChunk>(coord);
     return cpuChunk->toRenderable(vertexBufferObjects, cubeElementBufferObjects,
                                   waterElementBufferObjects);
 }
 
-Coord::CpuChunksMap ChunkLoader::generateMissingChunks(
-    int camChunkX, int camChunkZ,
-    const std::unordered_set<ChunkCoord, PositionXYHash>& existingKeys) {
-    Coord::CpuChunksMap newChunks;
-    for (int x = camChunkX - renderDistance; x <= camChunkX + renderDistance;
-         ++x) {
-        for (int z = camChunkZ - renderDistance;
-             z <= camChunkZ + renderDistance; ++z) {
-            ChunkCoord coord{x, z};
-            if (existingKeys.find(coord) == existingKeys.end()) {
-                newChunks[coord] = std::make_unique<CpuChunk>(chunkSize, x, z);
+void ChunkLoader::generateMissingChunks(
+    const ChunkWindow& window, const ChunkCoord& cameraCoord,
+    const std::unordered_set<ChunkCoord, ChunkCoordHash>& existingKeys,
+    const SavedChunks& savedChunks) {
+    std::vector<ChunkCoord> missing;
+    for (int x = window.minX; x <= window.maxX; ++x) {
+        for (int z = window.minZ; z <= window.maxZ; ++z) {
+            for (int y = window.minY; y <= window.maxY; ++y) {
+                const ChunkCoord coord{x, y, z};
+                if (existingKeys.find(coord) == existingKeys.end()) {
+                    missing.push_back(coord);
+                }
             }
         }
     }
-    return newChunks;
+    // The camera's own layer first, then the layers next to it; within a
+    // layer, nearest first.
+    const auto priorityOf = [&cameraCoord](const ChunkCoord& coord) {
+        const int dx{coord.x - cameraCoord.x};
+        const int dz{coord.z - cameraCoord.z};
+        return std::pair{std::abs(coord.y - cameraCoord.y), dx * dx + dz * dz};
+    };
+    std::sort(missing.begin(), missing.end(),
+              [&priorityOf](const ChunkCoord& a, const ChunkCoord& b) {
+                  return priorityOf(a) < priorityOf(b);
+              });
+
+    for (const auto& coord : missing) {
+        const auto saved = savedChunks.find(coord);
+        auto chunk = saved != savedChunks.end()
+                         ? std::make_unique<CpuChunk>(
+                               ChunkVoxels::restore(coord, saved->second))
+                         : std::make_unique<CpuChunk>(coord);
+        std::lock_guard lock(readyChunksMutex);
+        readyChunks[coord] = std::move(chunk);
+    }
 }
 
 void ChunkLoader::launchTask(
-    int camChunkX, int camChunkZ,
-    const std::unordered_set<ChunkCoord, PositionXYHash>& existingKeys) {
-    newChunkGroup =
-        std::async(std::launch::async, &ChunkLoader::generateMissingChunks,
-                   this, camChunkX, camChunkZ, existingKeys);
+    const ChunkWindow& window, const ChunkCoord& cameraCoord,
+    const std::unordered_set<ChunkCoord, ChunkCoordHash>& existingKeys,
+    SavedChunks&& savedChunks) {
+    newChunkGroup = std::async(std::launch::async,
+                               [this, window, cameraCoord, existingKeys,
+                                saved = std::move(savedChunks)]() {
+                                   generateMissingChunks(window, cameraCoord,
+                                                         existingKeys, saved);
+                               });
     isRunning = true;
 }
 
@@ -78,11 +104,25 @@ bool ChunkLoader::isFinished() const {
 }
 
 Coord::CpuChunksMap ChunkLoader::retrieveNewChunks() {
-    isRunning = false;
-    return newChunkGroup.get();
+    // Checked first: a finished task has handed over every chunk it built.
+    const bool finished{isFinished()};
+    Coord::CpuChunksMap newChunks;
+    {
+        std::lock_guard lock(readyChunksMutex);
+        newChunks.swap(readyChunks);
+    }
+    if (finished) {
+        newChunkGroup.get();
+        isRunning = false;
+    }
+    return newChunks;
 }
 
 ChunkLoader::~ChunkLoader() {
+    // The task writes into readyChunks; it must be done before they go.
+    if (newChunkGroup.valid()) {
+        newChunkGroup.wait();
+    }
     glDeleteBuffers(1, &vertexBufferObjects);
     glDeleteBuffers(1, &cubeElementBufferObjects);
     glDeleteBuffers(1, &waterElementBufferObjects);
@@ -0,0 +1,57 @@
+#include "ChunkMeshCache.hpp"
+#include <iterator>
+#include <utility>
+
+ChunkMeshCache::ChunkMeshCache(std::size_t budget) : budgetBytes{budget} {}
+
+void ChunkMeshCache::setBudget(std::size_t budget) {
+    budgetBytes = budget;
+    dropOldestOverBudget();
+}
+
+void ChunkMeshCache::insert(const ChunkCoord& coord, RetainedMesh&& mesh) {
+    erase(coord);
+    const auto bytes = mesh.getResidentBytes();
+    if (bytes > budgetBytes) {
+        return;
+    }
+    entries.push_front({coord, std::move(mesh), bytes});
+    index.emplace(coord, entries.begin());
+    residentBytes += bytes;
+    dropOldestOverBudget();
+}
+
+std::optional<RetainedMesh> ChunkMeshCache::take(const ChunkCoord& coord) {
+    const auto found = index.find(coord);
+    if (found == index.end()) {
+        return std::nullopt;
+    }
+    auto mesh = std::move(found->second->mesh);
+    eraseEntry(found->second);
+    return mesh;
+}
+
+void ChunkMeshCache::erase(const ChunkCoord& coord) {
+    const auto found = index.find(coord);
+    if (found != index.end()) {
+        eraseEntry(found->second);
+    }
+}
+
+void ChunkMeshCache::clear() {
+    entries.clear();
+    index.clear();
+    residentBytes = 0;
+}
+
+void ChunkMeshCache::eraseEntry(EntryList::iterator entry) {
+    residentBytes -= entry->bytes;
+    index.erase(entry->coord);
+    entries.erase(entry);
+}
+
+void ChunkMeshCache::dropOldestOverBudget() {
+    while (residentBytes > budgetBytes) {
+        eraseEntry(std::prev(entries.end()));
+    }
+}
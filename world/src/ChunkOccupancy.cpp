@@ -0,0 +1,16 @@
+#include "ChunkOccupancy.hpp"
+#include "BlockRegistry.hpp"
+
+void ChunkOccupancy::rebuild(const VoxelTypes::VoxelGrid3D& grid) {
+    std::array<CubeType, CHUNK_SIZE> cells{};
+    for (int z = 0; z < CHUNK_SIZE; ++z) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            grid.readColumn(x, z, cells.data());
+            ColumnMask column{0};
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                column |= ColumnMask{BlockRegistry::isSolid(cells[y])} << y;
+            }
+            columns[indexOf(x, z)] = column;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include "ChunkTable.hpp"
+
+namespace {
+constexpr std::size_t INITIAL_CAPACITY{64};
+/** Live entries plus tombstones may fill at most 3/4 of the table, so every
+ * probe sequence ends on an empty entry. */
+constexpr std::size_t MAX_LOAD_NUMERATOR{3};
+constexpr std::size_t MAX_LOAD_DENOMINATOR{4};
+
+/** Power-of-two capacity that keeps `count` entries at most half full. */
+std::size_t capacityFor(std::size_t count) {
+    auto capacity = INITIAL_CAPACITY;
+    while (count * 2 > capacity) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+} // namespace
+
+ChunkTable::ChunkTable() : entries(INITIAL_CAPACITY) {}
+
+std::size_t ChunkTable::probe(const ChunkCoord& coord, bool& found) const {
+    const auto mask = entries.size() - 1;
+    auto index = static_cast<std::size_t>(hashChunkCoord(coord)) & mask;
+    std::optional<std::size_t> firstTombstone{};
+    while (true) {
+        const auto& entry = entries[index];
+        if (entry.state == EntryState::EMPTY) {
+            found = false;
+            return firstTombstone.value_or(index);
+        }
+        if (entry.state == EntryState::TOMBSTONE) {
+            if (not firstTombstone) {
+                firstTombstone = index;
+            }
+        } else if (entry.coord == coord) {
+            found = true;
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+ChunkSlot* ChunkTable::find(const ChunkCoord& coord) {
+    bool found{false};
+    const auto index = probe(coord, found);
+    return found ? &entries[index].slot : nullptr;
+}
+
+const ChunkSlot* ChunkTable::find(const ChunkCoord& coord) const {
+    bool found{false};
+    const auto index = probe(coord, found);
+    return found ? &entries[index].slot : nullptr;
+}
+
+RenderableChunk* ChunkTable::findRenderable(const ChunkCoord& coord) const {
+    const auto* slot = find(coord);
+    return slot ? slot->renderable.get() : nullptr;
+}
+
+ChunkSlot& ChunkTable::findOrInsert(const ChunkCoord& coord) {
+    bool found{false};
+    auto index = probe(coord, found);
+    if (found) {
+        return entries[index].slot;
+    }
+    if (needsRehashBeforeInsert()) {
+        rehash(capacityFor(occupiedCount + 1));
+        index = probe(coord, found);
+    }
+    auto& entry = entries[index];
+    if (entry.state == EntryState::TOMBSTONE) {
+        --tombstoneCount;
+    }
+    entry.coord = coord;
+    entry.state = EntryState::OCCUPIED;
+    ++occupiedCount;
+    return entry.slot;
+}
+
+void ChunkTable::eraseIfEmpty(const ChunkCoord& coord) {
+    bool found{false};
+    const auto index = probe(coord, found);
+    if (not found or not entries[index].slot.isEmpty()) {
+        return;
+    }
+    entries[index].state = EntryState::TOMBSTONE;
+    --occupiedCount;
+    ++tombstoneCount;
+}
+
+bool ChunkTable::needsRehashBeforeInsert() const {
+    return (occupiedCount + tombstoneCount + 1) * MAX_LOAD_DENOMINATOR >
+           entries.size() * MAX_LOAD_NUMERATOR;
+}
+
+void ChunkTable::rehash(std::size_t newCapacity) {
+    std::vector<Entry> oldEntries(newCapacity);
+    std::swap(entries, oldEntries);
+    occupiedCount = 0;
+    tombstoneCount = 0;
+    for (auto& oldEntry : oldEntries) {
+        if (oldEntry.state != EntryState::OCCUPIED) {
+            continue;
+        }
+        bool found{false};
+        auto& entry = entries[probe(oldEntry.coord, found)];
+        entry.coord = oldEntry.coord;
+        entry.state = EntryState::OCCUPIED;
+        entry.slot = std::move(oldEntry.slot);
+        ++occupiedCount;
+    }
+}
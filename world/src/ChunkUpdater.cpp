@@ -6,15 +6,21 @@ ChunkUpdater::ChunkUpdater(RenderableChunk* chunkToUpdate)
 ChunkUpdater::~ChunkUpdater() {}
 
 void ChunkUpdater::launchUpdate() {
-    if (not isUpdating) {
+    if (not isUpdating and chunk) {
+        auto snapshot = chunk->takeSnapshot();
+        if (snapshot.scope == RebuildScope::SECTIONS) {
+            // A few remeshed sections cost less than handing them to a
+            // thread, and applying them now saves a frame of latency. The
+            // snapshot is gone before the apply, so the grid can compact.
+            auto data = ChunkVoxels::computeCubeData(std::move(snapshot));
+            chunk->applyCubeData(std::move(data));
+            return;
+        }
         isUpdating = true;
-        auto* target = chunk;
-        updateResult = std::async(std::launch::async, [target]() {
-            if (target) {
-                return target->computeCubeData();
-            }
-            return CubeData{};
-        });
+        updateResult = std::async(
+            std::launch::async, [snapshot = std::move(snapshot)]() mutable {
+                return ChunkVoxels::computeCubeData(std::move(snapshot));
+            });
     }
 }
 
@@ -23,8 +29,10 @@ void ChunkUpdater::checkAndApplyUpdate() {
         if (updateResult.wait_for(std::chrono::milliseconds(0)) ==
             std::future_status::ready) {
             chunk->applyCubeData(updateResult.get());
-            chunk->clearNeighborsSurroundingCubes();
             isUpdating = false;
+            if (chunk->isModified()) {
+                launchUpdate();
+            }
         }
     }
 }
\ No newline at end of file
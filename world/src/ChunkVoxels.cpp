@@ -1,296 +1,589 @@
 #include "ChunkVoxels.hpp"
 #include "VertexData.hpp"
 #include "LightPropagator.hpp"
+#include "BlockRegistry.hpp"
+#include "ChunkFaceMasks.hpp"
+#include "GreedyMesher.hpp"
+#include "TerrainHeightField.hpp"
+#include "LodDownsampler.hpp"
 #include "WaterSystem.hpp"
 #include "WaterMeshBuilder.hpp"
 #include "ChunkCoord.hpp"
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <queue>
 #include <iostream>
 #include "VoxelTypes.hpp"
 
 namespace {
-constexpr int WATER_HEIGHT{14};
-
-bool isWaterFaceExposed(const VoxelTypes::VoxelGrid3D& grid,
-                        const glm::ivec3& pos, CubeType currentType) {
-    const int chunkSize = static_cast<int>(grid.size());
-
-    for (const auto& offset : NEIGHBOR_OFFSETS) {
-        glm::ivec3 neighbor = pos + offset;
-
-        if (not isPositionWithinBounds(neighbor, chunkSize)) {
-            return true;
-        }
-
-        const CubeType neighborType = grid[neighbor.x][neighbor.z][neighbor.y];
-
-        if (WaterSystem::shouldRenderWaterFace(currentType, neighborType)) {
-            return true;
-        }
-    }
-    return false;
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int WATER_HEIGHT{TerrainHeightField::SEA_LEVEL};
+constexpr int SECTION_SIZE{VoxelTypes::VoxelGrid3D::SECTION_SIZE};
+/** Below this many edits a saved edit list is always smaller than a packed
+ * grid, so packing is not even attempted. */
+constexpr std::size_t EDITS_WORTH_PACKING{4096};
+
+bool isSolid(CubeType type) { return BlockRegistry::isSolid(type); }
+
+CpuWaterMesh buildWaterMesh(const VoxelTypes::VoxelGrid3D& grid,
+                            const BlockStateTable& blockStates,
+                            const glm::vec3& chunkOrigin) {
+    // Chunks are built on several threads; each keeps its own scratch.
+    thread_local WaterMeshBuilder meshBuilder;
+    return meshBuilder.build(grid, blockStates, chunkOrigin);
 }
 
-bool isSolidFaceExposed(const VoxelTypes::VoxelGrid3D& grid,
-                        const glm::ivec3& pos) {
-    const int chunkSize = static_cast<int>(grid.size());
-
-    for (const auto& offset : NEIGHBOR_OFFSETS) {
-        glm::ivec3 neighbor = pos + offset;
-
-        if (not isPositionWithinBounds(neighbor, chunkSize)) {
-            return true;
-        }
-
-        const CubeType neighborType = grid[neighbor.x][neighbor.z][neighbor.y];
+/** Greedy quads of the downsampled grid, with every face on the chunk
+ * border kept: the neighbors may be drawn at another level, so their cells
+ * say nothing about what covers those faces, and the extra faces close the
+ * seams between levels like skirts. */
+void buildCoarseMesh(const VoxelTypes::VoxelGrid3D& grid,
+                     const ChunkHeightmap& heightmap, LodLevel level,
+                     const glm::vec3& chunkOrigin, ChunkMesh& mesh) {
+    const auto coarseGrid = LodDownsampler::downsample(grid, heightmap, level);
+    const auto masks = std::make_unique<ChunkFaceMasks>();
+    masks->build(coarseGrid);
+    GreedyMesher::buildQuads(coarseGrid, *masks, chunkOrigin, mesh);
+}
+} // namespace
 
-        if (neighborType == CubeType::NONE or
-            WaterSystem::isWater(neighborType)) {
-            return true;
-        }
-    }
-    return false;
+ChunkVoxels::ChunkVoxels(const ChunkCoord& coord)
+    : chunkCoord{coord},
+      treeGenerator{coord},
+      voxelGrid{std::make_shared<VoxelTypes::VoxelGrid3D>(
+          GridGenerator(coord).generateGrid(heightmap))} {
+    placeWaterBlocks();
+    waterMesh = buildWaterMesh(*voxelGrid, blockStates, getChunkOrigin());
+    treeGenerator.generateTrees(*voxelGrid, heightmap);
+    occupancy.rebuild(*voxelGrid);
+    heightmap.rebuild(occupancy);
+    voxelGrid->compact();
 }
 
-bool isCubeExposed(const VoxelTypes::VoxelGrid3D& grid, const glm::ivec3& pos) {
-    const CubeType currentType = grid[pos.x][pos.z][pos.y];
+ChunkVoxels::ChunkVoxels(const ChunkCoord& coord,
+                         const PackedVoxels& packedVoxels)
+    : chunkCoord{coord},
+      treeGenerator{coord},
+      voxelGrid{
+          std::make_shared<VoxelTypes::VoxelGrid3D>(packedVoxels.unpack())},
+      savedAsPackedGrid{true} {
+    treeGenerator.markTreesGenerated();
+    occupancy.rebuild(*voxelGrid);
+    heightmap.rebuild(occupancy);
+    collectTorchPositions();
+    placeWaterBlocks();
+    waterMesh = buildWaterMesh(*voxelGrid, blockStates, getChunkOrigin());
+}
 
-    if (WaterSystem::isWater(currentType)) {
-        return isWaterFaceExposed(grid, pos, currentType);
-    } else {
-        return isSolidFaceExposed(grid, pos);
+ChunkVoxels ChunkVoxels::restore(const ChunkCoord& coord,
+                                 const SavedChunk& savedChunk) {
+    if (const auto* packedVoxels = savedChunk.getPackedVoxels()) {
+        ChunkVoxels voxels{coord, *packedVoxels};
+        voxels.blockStates = savedChunk.getBlockStates();
+        return voxels;
     }
+    ChunkVoxels voxels{coord};
+    voxels.replayEdits(*savedChunk.getEdits());
+    voxels.blockStates = savedChunk.getBlockStates();
+    return voxels;
 }
-} // namespace
 
-ChunkVoxels::ChunkVoxels(int chunkSize, int worldXIndex, int worldZIndex)
-    : size{chunkSize},
-      chunkWorldXIndex{worldXIndex},
-      chunkWorldZIndex{worldZIndex},
-      treeGenerator{chunkSize},
-      voxelGrid(generateInitialVoxelGrid()) {
-    rebuildCubesFromGrid();
+std::optional<SavedChunk> ChunkVoxels::save() const {
+    std::lock_guard lock(voxelMutex);
+    if (edits.empty() and not savedAsPackedGrid) {
+        return std::nullopt;
+    }
+    if (savedAsPackedGrid or edits.size() >= EDITS_WORTH_PACKING) {
+        PackedVoxels packedVoxels{*voxelGrid};
+        const auto editBytes = edits.size() * sizeof(SavedChunk::VoxelEdit);
+        if (savedAsPackedGrid or packedVoxels.getResidentBytes() < editBytes) {
+            return SavedChunk{std::move(packedVoxels), blockStates};
+        }
+    }
+    return SavedChunk{edits, blockStates};
 }
 
 ChunkVoxels::ChunkVoxels(ChunkVoxels&& other) noexcept
-    : size(other.size),
-      chunkWorldXIndex(other.chunkWorldXIndex),
-      chunkWorldZIndex(other.chunkWorldZIndex),
+    : ChunkVoxels(std::move(other), std::lock_guard{other.voxelMutex}) {}
+
+ChunkVoxels::ChunkVoxels(ChunkVoxels&& other,
+                         const std::lock_guard<std::mutex>&) noexcept
+    : chunkCoord(other.chunkCoord),
       treeGenerator(std::move(other.treeGenerator)),
+      heightmap(other.heightmap),
+      occupancy(other.occupancy),
       voxelGrid(std::move(other.voxelGrid)),
-      cubes(std::move(other.cubes)),
-      instanceModelMatrices(std::move(other.instanceModelMatrices)),
+      gridReaders(std::move(other.gridReaders)),
+      blockStates(std::move(other.blockStates)),
       torchPositions(std::move(other.torchPositions)),
-      waterMeshData(std::move(other.waterMeshData)),
-      modified(other.modified) {}
+      neighborHalo(std::move(other.neighborHalo)),
+      openBorderFaces(other.openBorderFaces),
+      edits(std::move(other.edits)),
+      savedAsPackedGrid(other.savedAsPackedGrid),
+      meshingMode(other.meshingMode),
+      lodLevel(other.lodLevel),
+      pendingScope(other.pendingScope),
+      dirtySections(other.dirtySections),
+      waterMesh(std::move(other.waterMesh)),
+      editVersion(other.editVersion),
+      snapshotVersion(other.snapshotVersion),
+      appliedVersion(other.appliedVersion) {}
 
 ChunkVoxels& ChunkVoxels::operator=(ChunkVoxels&& other) noexcept {
     if (this != &other) {
         std::lock_guard lock(other.voxelMutex);
-        size = other.size;
-        chunkWorldXIndex = other.chunkWorldXIndex;
-        chunkWorldZIndex = other.chunkWorldZIndex;
+        chunkCoord = other.chunkCoord;
         treeGenerator = std::move(other.treeGenerator);
         voxelGrid = std::move(other.voxelGrid);
-        cubes = std::move(other.cubes);
-        instanceModelMatrices = std::move(other.instanceModelMatrices);
+        gridReaders = std::move(other.gridReaders);
+        blockStates = std::move(other.blockStates);
         torchPositions = std::move(other.torchPositions);
-        waterMeshData = std::move(other.waterMeshData);
-        modified = other.modified;
+        neighborHalo = std::move(other.neighborHalo);
+        openBorderFaces = other.openBorderFaces;
+        heightmap = other.heightmap;
+        occupancy = other.occupancy;
+        edits = std::move(other.edits);
+        savedAsPackedGrid = other.savedAsPackedGrid;
+        meshingMode = other.meshingMode;
+        lodLevel = other.lodLevel;
+        pendingScope = other.pendingScope;
+        dirtySections = other.dirtySections;
+        waterMesh = std::move(other.waterMesh);
+        editVersion = other.editVersion;
+        snapshotVersion = other.snapshotVersion;
+        appliedVersion = other.appliedVersion;
     }
     return *this;
 }
 
-const std::unordered_map<CubeType, std::vector<glm::mat4>>&
-ChunkVoxels::getInstanceModelMatrices() const {
-    return instanceModelMatrices;
+GridReadLease::GridReadLease(std::shared_ptr<std::atomic<int>> gridReaders)
+    : readers(std::move(gridReaders)) {
+    // Taken with the chunk's mutex held, which orders it before the check.
+    readers->fetch_add(1, std::memory_order_relaxed);
+}
+
+GridReadLease::~GridReadLease() { release(); }
+
+GridReadLease& GridReadLease::operator=(GridReadLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        readers = std::move(other.readers);
+    }
+    return *this;
+}
+
+void GridReadLease::release() {
+    if (readers) {
+        readers->fetch_sub(1, std::memory_order_release);
+        readers.reset();
+    }
 }
 
 glm::vec3 ChunkVoxels::getChunkOrigin() const {
-    return glm::vec3(chunkWorldXIndex * size, 0.0f, chunkWorldZIndex * size);
+    return glm::vec3(ChunkGeometry::toWorldOrigin(chunkCoord.x),
+                     ChunkGeometry::toWorldOrigin(chunkCoord.y),
+                     ChunkGeometry::toWorldOrigin(chunkCoord.z));
 }
 
-void ChunkVoxels::setModified(bool value) {
+void ChunkVoxels::markModified() {
     std::lock_guard lock(voxelMutex);
-    modified = value;
+    widenPendingScope(RebuildScope::FULL);
+    ++editVersion;
 }
 
-void ChunkVoxels::setNeighborsSurroundingCubes(
-    VoxelTypes::NeighborVoxelsMap&& data) {
+void ChunkVoxels::markBorderModified() {
     std::lock_guard lock(voxelMutex);
-    neighborsSurroundingCubes = std::move(data);
+    widenPendingScope(RebuildScope::MESH);
+    ++editVersion;
 }
-void ChunkVoxels::clearNeighborsSurroundingCubes() {
+
+void ChunkVoxels::widenPendingScope(RebuildScope scope) {
+    pendingScope = std::max(pendingScope, scope);
+}
+
+void ChunkVoxels::markSectionsAround(const glm::ivec3& localPos) {
+    const auto markSection = [this](const glm::ivec3& pos) {
+        if (ChunkGeometry::isWithinChunk(pos)) {
+            const auto section =
+                VoxelTypes::VoxelGrid3D::sectionIndexOf(pos.x, pos.y, pos.z);
+            dirtySections |= ChunkMesh::SectionMask{1} << section;
+        }
+    };
+    markSection(localPos);
+    for (const auto& offset : NEIGHBOR_OFFSETS) {
+        markSection(localPos + offset);
+    }
+}
+
+bool ChunkVoxels::acceptRebuild(std::uint64_t version) {
     std::lock_guard lock(voxelMutex);
-    neighborsSurroundingCubes.clear();
+    if (version <= appliedVersion) {
+        return false;
+    }
+    appliedVersion = version;
+    return true;
+}
+
+bool ChunkVoxels::isRebuildCurrent() const {
+    std::lock_guard lock(voxelMutex);
+    return appliedVersion == editVersion;
+}
+
+void ChunkVoxels::adoptRebuild(std::uint64_t version, MeshingMode mode,
+                               LodLevel level,
+                               ChunkFaceMasks::FaceSet openFaces) {
+    std::lock_guard lock(voxelMutex);
+    meshingMode = mode;
+    lodLevel = level;
+    openBorderFaces = openFaces;
+    pendingScope = RebuildScope::SECTIONS;
+    dirtySections = 0;
+    editVersion = version;
+    snapshotVersion = version;
+    appliedVersion = version;
+}
+
+void ChunkVoxels::setNeighborHalo(const ChunkHalo& halo) {
+    std::lock_guard lock(voxelMutex);
+    neighborHalo = halo;
+}
+
+void ChunkVoxels::setOpenBorderFaces(ChunkFaceMasks::FaceSet faces) {
+    std::lock_guard lock(voxelMutex);
+    openBorderFaces = faces;
+}
+
+void ChunkVoxels::setMeshingMode(MeshingMode mode) {
+    std::lock_guard lock(voxelMutex);
+    if (meshingMode != mode) {
+        meshingMode = mode;
+        widenPendingScope(RebuildScope::MESH);
+        ++editVersion;
+    }
+}
+
+void ChunkVoxels::setLodLevel(LodLevel level) {
+    std::lock_guard lock(voxelMutex);
+    if (lodLevel != level) {
+        lodLevel = level;
+        widenPendingScope(RebuildScope::MESH);
+        ++editVersion;
+    }
 }
 
 bool ChunkVoxels::addCube(const glm::ivec3& localPos, CubeType cubeType) {
     std::lock_guard lock(voxelMutex);
-    if (not isPositionWithinBounds(localPos, size) or isCubeInGrid(localPos)) {
+    if (not ChunkGeometry::isWithinChunk(localPos) or isCubeInGrid(localPos)) {
         return false;
     }
-    voxelGrid[localPos.x][localPos.z][localPos.y] = cubeType;
-    if (cubeType == CubeType::TORCH) {
-        torchPositions.push_back(localPos);
-    }
-    modified = true;
+    writeVoxel(localPos, cubeType);
     return true;
 }
 
 bool ChunkVoxels::removeCube(const glm::ivec3& localPos) {
     std::lock_guard lock(voxelMutex);
-    if (not isPositionWithinBounds(localPos, size) or
+    if (not ChunkGeometry::isWithinChunk(localPos) or
         not isCubeInGrid(localPos)) {
         return false;
     }
-    if (voxelGrid[localPos.x][localPos.z][localPos.y] == CubeType::TORCH) {
+    writeVoxel(localPos, CubeType::NONE);
+    return true;
+}
+
+ChunkVoxels::BulkWriteResult ChunkVoxels::writeVoxels(
+    const std::vector<VoxelTypes::VoxelWrite>& writes) {
+    std::lock_guard lock(voxelMutex);
+    BulkWriteResult result{};
+    for (const auto& write : writes) {
+        if (not ChunkGeometry::isWithinChunk(write.localPos)) {
+            continue;
+        }
+        // Compared as stored, or air over the sea would count every time.
+        const auto type = resolveWriteType(write.localPos, write.type);
+        const BlockState state{BlockRegistry::isStateful(type) ? write.state
+                                                               : BlockState{0}};
+        const auto previous = (*voxelGrid)[write.localPos];
+        if (previous == type and blockStates.at(write.localPos) == state) {
+            continue;
+        }
+        result.lightSourcesChanged |= BlockRegistry::isEmissive(previous) or
+                                      BlockRegistry::isEmissive(type);
+        writeVoxel(write.localPos, write.type, write.state);
+        ++result.changedCount;
+    }
+    return result;
+}
+
+VoxelTypes::VoxelGrid3D& ChunkVoxels::mutableGrid() {
+    if (isGridLeased()) {
+        voxelGrid = std::make_shared<VoxelTypes::VoxelGrid3D>(*voxelGrid);
+        gridReaders = std::make_shared<std::atomic<int>>(0);
+    }
+    return *voxelGrid;
+}
+
+bool ChunkVoxels::isGridLeased() const {
+    return gridReaders->load(std::memory_order_acquire) > 0;
+}
+
+CubeType ChunkVoxels::resolveWriteType(const glm::ivec3& localPos,
+                                       CubeType cubeType) const {
+    if (cubeType == CubeType::NONE and
+        ChunkGeometry::toWorldOrigin(chunkCoord.y) + localPos.y ==
+            WATER_HEIGHT) {
+        // The sea refills a hole dug at its surface right away.
+        return CubeType::WATER_SOURCE;
+    }
+    return cubeType;
+}
+
+void ChunkVoxels::writeVoxel(const glm::ivec3& localPos, CubeType cubeType,
+                             BlockState state) {
+    auto& grid = mutableGrid();
+    const auto previous = grid[localPos];
+    if (BlockRegistry::isEmissive(previous)) {
         auto it =
             std::find(torchPositions.begin(), torchPositions.end(), localPos);
         if (it != torchPositions.end()) {
             torchPositions.erase(it);
         }
     }
-    voxelGrid[localPos.x][localPos.z][localPos.y] = CubeType::NONE;
-    treeGenerator.removeTreeCubeAt(localPos);
-    modified = true;
-    return true;
+    if (cubeType == CubeType::NONE) {
+        treeGenerator.removeTreeCubeAt(localPos);
+    }
+    cubeType = resolveWriteType(localPos, cubeType);
+    grid.set(localPos, cubeType);
+    const bool keepsState{BlockRegistry::isStateful(cubeType)};
+    blockStates.set(localPos, keepsState ? state : BlockState{0});
+    occupancy.set(localPos, isSolid(cubeType));
+    heightmap.update(occupancy, localPos.x, localPos.z);
+    if (BlockRegistry::isEmissive(cubeType)) {
+        torchPositions.push_back(localPos);
+    }
+    edits[localPos] = cubeType;
+    // Water surfaces and light sources are rebuilt for the whole chunk; any
+    // other edit only changes the faces around it.
+    const bool changesWater{BlockRegistry::isFluid(previous) or
+                            BlockRegistry::isFluid(cubeType)};
+    const bool changesLight{BlockRegistry::isEmissive(previous) or
+                            BlockRegistry::isEmissive(cubeType)};
+    if (changesWater or changesLight) {
+        widenPendingScope(RebuildScope::FULL);
+    }
+    markSectionsAround(localPos);
+    ++editVersion;
 }
 
-bool ChunkVoxels::isCubeInGrid(const glm::ivec3& localPos) const {
-    return voxelGrid[localPos.x][localPos.z][localPos.y] != CubeType::NONE;
+void ChunkVoxels::replayEdits(
+    const std::vector<SavedChunk::VoxelEdit>& savedEdits) {
+    std::lock_guard lock(voxelMutex);
+    for (const auto& edit : savedEdits) {
+        writeVoxel({edit.x, edit.y, edit.z}, edit.type);
+    }
+    mutableGrid().compact();
 }
 
-CubeData ChunkVoxels::computeCubeData() {
+void ChunkVoxels::compactSections() {
     std::lock_guard lock(voxelMutex);
-    const float attenuation{0.8f};
-    LightPropagator lp(size, attenuation);
-
-    CubeData data;
-    data.lightVolume = lp.computeLightMask(voxelGrid, torchPositions,
-                                           neighborsSurroundingCubes);
-    neighborsSurroundingCubes.clear();
-
-    auto instanceBuilder = [&](const glm::ivec3& worldPos, CubeType type) {
-        auto cube = std::make_unique<Cube>(worldPos, type);
-        data.instanceModelMatrices[type].push_back(cube->getModel());
-        data.cubes.push_back(std::move(cube));
-    };
-    regenerateChunk(instanceBuilder);
-    return data;
+    if (not isGridLeased()) {
+        voxelGrid->compact();
+    }
 }
 
-CubeType ChunkVoxels::getCubeTypeAt(const glm::ivec3& position) const {
-    return voxelGrid[position.x][position.z][position.y];
+bool ChunkVoxels::isCubeInGrid(const glm::ivec3& localPos) const {
+    return (*voxelGrid)[localPos] != CubeType::NONE;
 }
 
-void ChunkVoxels::storeCubes(std::vector<std::unique_ptr<Cube>>&& newCubes) {
+ChunkSnapshot ChunkVoxels::takeSnapshot() {
     std::lock_guard lock(voxelMutex);
-    cubes = std::move(newCubes);
+    auto scope = pendingScope;
+    // Light from the neighbors comes through the halo, so a halo with a
+    // light source needs relighting even when only the border changed.
+    // Light from inside the chunk follows every edit of its blocks.
+    if (neighborHalo.containsLightSource() or
+        (scope == RebuildScope::SECTIONS and not torchPositions.empty())) {
+        scope = RebuildScope::FULL;
+    }
+    // Merged faces span whole slices, so they are always rebuilt entirely.
+    if (scope == RebuildScope::SECTIONS and
+        (meshingMode == MeshingMode::GREEDY_QUADS or
+         lodLevel != LodLevel::FULL)) {
+        scope = RebuildScope::MESH;
+    }
+    ChunkSnapshot snapshot{editVersion,    voxelGrid,        blockStates,
+                           torchPositions, neighborHalo,     openBorderFaces,
+                           heightmap,      getChunkOrigin(), meshingMode,
+                           lodLevel,       scope,            dirtySections,
+                           GridReadLease{gridReaders}};
+    neighborHalo.clear();
+    pendingScope = RebuildScope::SECTIONS;
+    dirtySections = 0;
+    snapshotVersion = editVersion;
+    return snapshot;
 }
 
-std::pair<glm::vec3, glm::vec3> ChunkVoxels::computeChunkAABB() const {
-    const auto firstCubeXWorldPosition = chunkWorldXIndex * size;
-    const auto chunkOriginBlockPositionY = 0.0f;
-    const auto firstCubeZWorldPosition = chunkWorldZIndex * size;
-    const glm::vec3 chunkBoundsMin{firstCubeXWorldPosition,
-                                   chunkOriginBlockPositionY,
-                                   firstCubeZWorldPosition};
-    const auto chunkBoundsMax = chunkBoundsMin + glm::vec3(size);
-    return {chunkBoundsMin, chunkBoundsMax};
-}
+CubeData ChunkVoxels::computeCubeData(ChunkSnapshot snapshot) {
+    const auto& grid = *snapshot.voxelGrid;
 
-VoxelTypes::VoxelGrid3D ChunkVoxels::generateInitialVoxelGrid() {
-    return GridGenerator(size, chunkWorldXIndex, chunkWorldZIndex)
-        .generateGrid();
+    CubeData data;
+    data.version = snapshot.version;
+    data.scope = snapshot.scope;
+    if (snapshot.scope == RebuildScope::SECTIONS) {
+        processVoxelGrid(grid, snapshot.neighborHalo, snapshot.chunkOrigin,
+                         snapshot.meshingMode, data.mesh,
+                         snapshot.dirtySections, snapshot.openBorderFaces);
+        data.heightmap = snapshot.heightmap;
+        return data;
+    }
+    if (snapshot.lodLevel == LodLevel::FULL) {
+        processVoxelGrid(grid, snapshot.neighborHalo, snapshot.chunkOrigin,
+                         snapshot.meshingMode, data.mesh,
+                         ChunkMesh::ALL_SECTIONS, snapshot.openBorderFaces);
+    } else {
+        buildCoarseMesh(grid, snapshot.heightmap, snapshot.lodLevel,
+                        snapshot.chunkOrigin, data.mesh);
+    }
+    if (snapshot.scope == RebuildScope::MESH) {
+        return data;
+    }
+    const float attenuation{0.8f};
+    LightPropagator lp(attenuation);
+    data.lightVolume = lp.computeLightMask(grid, snapshot.torchPositions,
+                                           snapshot.neighborHalo);
+    data.waterMesh =
+        buildWaterMesh(grid, snapshot.blockStates, snapshot.chunkOrigin);
+    data.heightmap = snapshot.heightmap;
+    return data;
 }
 
-void ChunkVoxels::createCube(const glm::ivec3& worldCubePos,
-                             CubeType cubeType) {
-    cubes.push_back(std::make_unique<Cube>(worldCubePos, cubeType));
-    instanceModelMatrices[cubeType].push_back(cubes.back()->getModel());
+CubeData ChunkVoxels::computeCubeData() {
+    return computeCubeData(takeSnapshot());
 }
 
-void ChunkVoxels::processVoxelGrid(float firstCubeXWorldPosition,
-                                   float firstCubeZWorldPosition,
-                                   const CubeCreator& createCube) {
-    for (int x = 0; x < size; ++x)
-        for (int z = 0; z < size; ++z)
-            for (int y = 0; y < size; ++y) {
-                glm::ivec3 worldCubePos(firstCubeXWorldPosition + x, y,
-                                        firstCubeZWorldPosition + z);
-                auto cubeType = voxelGrid[x][z][y];
-                if (cubeType != CubeType::NONE and
-                    cubeType != CubeType::WATER_SOURCE and
-                    cubeType != CubeType::WATER_FLOWING and
-                    isCubeExposed(voxelGrid, {x, y, z})) {
-                    createCube(worldCubePos, cubeType);
-                }
-            }
+CubeType ChunkVoxels::getCubeTypeAt(const glm::ivec3& position) const {
+    return (*voxelGrid)[position];
 }
 
-void ChunkVoxels::regenerateChunk(const CubeCreator& createCube) {
-    const auto firstCubeXWorldPosition =
-        static_cast<float>(chunkWorldXIndex * size);
-    const auto firstCubeZWorldPosition =
-        static_cast<float>(chunkWorldZIndex * size);
-
-    processVoxelGrid(firstCubeXWorldPosition, firstCubeZWorldPosition,
-                     createCube);
-
-    buildWaterMeshData();
-
-    treeGenerator.generateTrees(voxelGrid);
-    treeGenerator.reapplyTrunks(firstCubeXWorldPosition,
-                                firstCubeZWorldPosition, createCube);
-    treeGenerator.reapplyCrowns(firstCubeXWorldPosition,
-                                firstCubeZWorldPosition, createCube);
+Voxel ChunkVoxels::getVoxelAt(const glm::ivec3& position) const {
+    return {(*voxelGrid)[position], blockStates.at(position)};
 }
 
-void ChunkVoxels::rebuildCubesFromGrid() {
-    cubes.clear();
-    instanceModelMatrices.clear();
-    regenerateChunk([this](const glm::ivec3& worldCubePos, CubeType cubeType) {
-        createCube(worldCubePos, cubeType);
-    });
+bool ChunkVoxels::setBlockState(const glm::ivec3& localPos, BlockState state) {
+    std::lock_guard lock(voxelMutex);
+    if (not ChunkGeometry::isWithinChunk(localPos)) {
+        return false;
+    }
+    const auto type = (*voxelGrid)[localPos];
+    if (not BlockRegistry::isStateful(type)) {
+        return false;
+    }
+    if (blockStates.at(localPos) != state) {
+        blockStates.set(localPos, state);
+        edits[localPos] = type;
+        widenPendingScope(RebuildScope::FULL);
+        ++editVersion;
+    }
+    return true;
 }
 
-void ChunkVoxels::buildWaterMeshData() {
-    waterMeshData.clear();
-    placeWaterBlocks();
-
-    WaterMeshBuilder meshBuilder;
-    const auto worldPos = computeChunkWorldPosition();
+void ChunkVoxels::readColumn(int localX, int localZ, CubeType* out) const {
+    voxelGrid->readColumn(localX, localZ, out);
+}
 
-    auto waterSurfaces =
-        meshBuilder.buildWaterSurfaces(voxelGrid, worldPos.x, worldPos.y);
-    storeValidWaterSurfaces(waterSurfaces);
+std::pair<glm::vec3, glm::vec3> ChunkVoxels::computeChunkAABB() const {
+    const auto chunkBoundsMin = getChunkOrigin();
+    const auto chunkBoundsMax = chunkBoundsMin + glm::vec3(CHUNK_SIZE);
+    return {chunkBoundsMin, chunkBoundsMax};
 }
 
-void ChunkVoxels::placeWaterBlocks() {
-    for (int x = 0; x < size; ++x) {
-        for (int z = 0; z < size; ++z) {
-            if (voxelGrid[x][z][WATER_HEIGHT] == CubeType::NONE) {
-                voxelGrid[x][z][WATER_HEIGHT] = CubeType::WATER_SOURCE;
+void ChunkVoxels::processVoxelGrid(const VoxelTypes::VoxelGrid3D& grid,
+                                   const ChunkHalo& halo,
+                                   const glm::vec3& chunkOrigin,
+                                   MeshingMode meshingMode, ChunkMesh& mesh,
+                                   ChunkMesh::SectionMask sections,
+                                   ChunkFaceMasks::FaceSet openFaces) {
+    const auto masks = std::make_unique<ChunkFaceMasks>();
+    if (meshingMode == MeshingMode::GREEDY_QUADS) {
+        masks->build(grid, halo, openFaces);
+        GreedyMesher::buildQuads(grid, *masks, chunkOrigin, mesh);
+        return;
+    }
+    if (sections == ChunkMesh::ALL_SECTIONS) {
+        masks->build(grid, halo, openFaces);
+    } else {
+        masks->build(grid, halo, openFaces, sections);
+    }
+    mesh.sections = sections;
+    // One map lookup per block type rather than per emitted cube.
+    struct TypeInstances {
+        std::vector<glm::vec3>* positions{nullptr};
+        ChunkMesh::SectionCounts* sectionCounts{nullptr};
+    };
+    std::array<TypeInstances, BlockRegistry::BLOCK_TYPE_COUNT>
+        instancesByType{};
+    constexpr int SECTIONS_PER_AXIS{CHUNK_SIZE / SECTION_SIZE};
+    constexpr ChunkFaceMasks::ColumnMask SECTION_BITS{
+        (ChunkFaceMasks::ColumnMask{1} << SECTION_SIZE) - 1};
+    for (; sections != 0; sections &= sections - 1) {
+        const auto section = std::countr_zero(sections);
+        const auto firstX = section / SECTIONS_PER_AXIS / SECTIONS_PER_AXIS *
+                            SECTION_SIZE;
+        const auto firstZ = section / SECTIONS_PER_AXIS % SECTIONS_PER_AXIS *
+                            SECTION_SIZE;
+        const auto firstY = section % SECTIONS_PER_AXIS * SECTION_SIZE;
+        for (int x = firstX; x < firstX + SECTION_SIZE; ++x) {
+            for (int z = firstZ; z < firstZ + SECTION_SIZE; ++z) {
+                const auto column = masks->exposedAt(x, z);
+                for (auto exposed = column & (SECTION_BITS << firstY);
+                     exposed != 0; exposed &= exposed - 1) {
+                    const auto y = std::countr_zero(exposed);
+                    const auto type = grid(x, y, z);
+                    auto& instances = instancesByType[static_cast<int>(type)];
+                    if (not instances.positions) {
+                        instances.positions = &mesh.instancePositions[type];
+                        instances.sectionCounts =
+                            &mesh.sectionInstanceCounts[type];
+                    }
+                    instances.positions->push_back(chunkOrigin +
+                                                   glm::vec3(x, y, z));
+                    ++(*instances.sectionCounts)[section];
+                }
             }
         }
     }
 }
 
-glm::vec2 ChunkVoxels::computeChunkWorldPosition() const {
-    const auto worldX = static_cast<float>(chunkWorldXIndex * size);
-    const auto worldZ = static_cast<float>(chunkWorldZIndex * size);
-    return {worldX, worldZ};
+void ChunkVoxels::collectTorchPositions() {
+    const auto& grid = *voxelGrid;
+    torchPositions.clear();
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                const glm::ivec3 pos{x, y, z};
+                if (grid.isUniformSectionAt(pos) and
+                    not BlockRegistry::isEmissive(grid[pos])) {
+                    y += SECTION_SIZE - 1;
+                } else if (BlockRegistry::isEmissive(grid[pos])) {
+                    torchPositions.push_back(pos);
+                }
+            }
+        }
+    }
 }
 
-void ChunkVoxels::storeValidWaterSurfaces(
-    const std::vector<WaterMeshBuilder::WaterSurface>& surfaces) {
-    waterMeshData.reserve(surfaces.size());
-    for (const auto& surface : surfaces) {
-        if (not surface.vertices.empty()) {
-            waterMeshData.emplace_back(surface.vertices, surface.indices,
-                                       surface.waterType, surface.center);
+void ChunkVoxels::placeWaterBlocks() {
+    const auto waterY =
+        WATER_HEIGHT - ChunkGeometry::toWorldOrigin(chunkCoord.y);
+    if (waterY < 0 or waterY >= CHUNK_SIZE) {
+        return;
+    }
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            if ((*voxelGrid)(x, waterY, z) == CubeType::NONE) {
+                voxelGrid->set(x, waterY, z, CubeType::WATER_SOURCE);
+            }
         }
     }
 }
+
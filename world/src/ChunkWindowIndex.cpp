@@ -0,0 +1,86 @@
+#include "ChunkWindowIndex.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+int torusExtent(int radius) {
+    return static_cast<int>(
+        std::bit_ceil(static_cast<unsigned>(2 * radius + 1)));
+}
+} // namespace
+
+ChunkWindowIndex::ChunkWindowIndex(const ChunkTable& chunkTable,
+                                   int renderDistance,
+                                   int verticalRenderDistance)
+    : table{chunkTable},
+      radius{renderDistance},
+      verticalRadius{verticalRenderDistance},
+      width{torusExtent(renderDistance)},
+      mask{width - 1},
+      height{torusExtent(verticalRenderDistance)},
+      heightMask{height - 1},
+      window{windowAround({0, 0, 0})},
+      cells(static_cast<std::size_t>(width) * width * height) {}
+
+ChunkWindow ChunkWindowIndex::windowAround(const ChunkCoord& center) const {
+    // A camera above or below the world keeps the nearest layers loaded.
+    constexpr int TOP_LAYER{ChunkGeometry::WORLD_HEIGHT_IN_CHUNKS - 1};
+    const int centerY{std::clamp(center.y, 0, TOP_LAYER)};
+    return {center.x - radius,
+            center.x + radius,
+            std::max(centerY - verticalRadius, 0),
+            std::min(centerY + verticalRadius, TOP_LAYER),
+            center.z - radius,
+            center.z + radius};
+}
+
+RenderableChunk* ChunkWindowIndex::find(const ChunkCoord& coord) const {
+    const auto& cell = cellAt(coord);
+    if (cell.chunk and cell.coord == coord) {
+        return cell.chunk;
+    }
+    if (isChunkWithinWindow(coord, window)) {
+        return nullptr;
+    }
+    return table.findRenderable(coord);
+}
+
+void ChunkWindowIndex::insert(const ChunkCoord& coord,
+                              RenderableChunk* chunk) {
+    auto& cell = cellAt(coord);
+    const bool keepsWindowChunk{cell.chunk and cell.coord != coord and
+                                isChunkWithinWindow(cell.coord, window) and
+                                not isChunkWithinWindow(coord, window)};
+    if (not keepsWindowChunk) {
+        cell = {coord, chunk};
+    }
+}
+
+void ChunkWindowIndex::erase(const ChunkCoord& coord) {
+    auto& cell = cellAt(coord);
+    if (cell.coord == coord) {
+        cell.chunk = nullptr;
+    }
+}
+
+void ChunkWindowIndex::recenter(const ChunkCoord& center) {
+    const auto previousWindow = window;
+    window = windowAround(center);
+    for (int x = window.minX; x <= window.maxX; ++x) {
+        for (int y = window.minY; y <= window.maxY; ++y) {
+            for (int z = window.minZ; z <= window.maxZ; ++z) {
+                const ChunkCoord coord{x, y, z};
+                if (isChunkWithinWindow(coord, previousWindow)) {
+                    continue;
+                }
+                auto& cell = cellAt(coord);
+                if (cell.chunk and cell.coord == coord) {
+                    continue;
+                }
+                if (auto* chunk = table.findRenderable(coord)) {
+                    cell = {coord, chunk};
+                }
+            }
+        }
+    }
+}
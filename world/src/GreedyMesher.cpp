@@ -0,0 +1,195 @@
+#include "GreedyMesher.hpp"
+#include <array>
+#include <bit>
+#include <utility>
+#include <vector>
+#include <glm/vec2.hpp>
+#include "BlockRegistry.hpp"
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr float HALF_BLOCK{0.5f};
+using Face = ChunkFaceMasks::Face;
+using ColumnMask = ChunkFaceMasks::ColumnMask;
+
+/** The axis the faces of one direction look along, the two axes spanning
+ * their slices, and the side of the block they lie on. */
+struct FaceAxes {
+    int normalAxis{0};
+    int uAxis{0};
+    int vAxis{0};
+    float planeOffset{0.0f};
+    /** (u, v) order runs clockwise seen from outside; emit it backwards. */
+    bool reversed{false};
+};
+
+/** In ChunkFaceMasks::Face order. The slice axes follow the texture layout
+ * of the instanced cube, so textures face the same way on both paths. */
+constexpr std::array<FaceAxes, ChunkFaceMasks::FACE_COUNT> FACE_AXES{{
+    {0, 2, 1, HALF_BLOCK, true},
+    {0, 2, 1, -HALF_BLOCK, false},
+    {1, 0, 2, HALF_BLOCK, true},
+    {1, 0, 2, -HALF_BLOCK, false},
+    {2, 0, 1, HALF_BLOCK, false},
+    {2, 0, 1, -HALF_BLOCK, true},
+}};
+
+struct Quad {
+    Face face{Face::POS_X};
+    int slice{0};
+    int u{0};
+    int v{0};
+    int width{0};
+    int height{0};
+};
+
+/** Block types of the visible faces of one slice, NONE where there is no
+ * face, indexed v * CHUNK_SIZE + u. */
+using SliceCells = std::array<CubeType, CHUNK_SIZE * CHUNK_SIZE>;
+using QuadsByType =
+    std::array<std::vector<Quad>, BlockRegistry::BLOCK_TYPE_COUNT>;
+
+/** False when the slice has no visible face at all. */
+bool fillSlice(const VoxelTypes::VoxelGrid3D& grid,
+               const ChunkFaceMasks& masks, Face face, int slice,
+               SliceCells& cells) {
+    const auto& axes = FACE_AXES[face];
+    bool hasFaces{false};
+    const auto visitColumn = [&](int x, int z, ColumnMask faces) {
+        for (; faces != 0; faces &= faces - 1) {
+            const glm::ivec3 pos{x, std::countr_zero(faces), z};
+            cells[pos[axes.vAxis] * CHUNK_SIZE + pos[axes.uAxis]] = grid[pos];
+            hasFaces = true;
+        }
+    };
+    cells.fill(CubeType::NONE);
+    if (axes.normalAxis == 0) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            visitColumn(slice, z, masks.facesAt(face, slice, z));
+        }
+    } else if (axes.normalAxis == 2) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            visitColumn(x, slice, masks.facesAt(face, x, slice));
+        }
+    } else {
+        const ColumnMask sliceBit{ColumnMask{1} << slice};
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            for (int z = 0; z < CHUNK_SIZE; ++z) {
+                visitColumn(x, z, masks.facesAt(face, x, z) & sliceBit);
+            }
+        }
+    }
+    return hasFaces;
+}
+
+/** Cuts the faces of cells into rectangles, clearing the cells it uses. */
+void mergeSlice(Face face, int slice, SliceCells& cells,
+                QuadsByType& quadsByType) {
+    const auto cellAt = [&cells](int u, int v) -> CubeType& {
+        return cells[v * CHUNK_SIZE + u];
+    };
+    for (int v = 0; v < CHUNK_SIZE; ++v) {
+        for (int u = 0; u < CHUNK_SIZE; ++u) {
+            const auto type = cellAt(u, v);
+            if (type == CubeType::NONE) {
+                continue;
+            }
+            int width{1};
+            while (u + width < CHUNK_SIZE and cellAt(u + width, v) == type) {
+                ++width;
+            }
+            int height{1};
+            for (; v + height < CHUNK_SIZE; ++height) {
+                bool rowMatches{true};
+                for (int du = 0; du < width and rowMatches; ++du) {
+                    rowMatches = cellAt(u + du, v + height) == type;
+                }
+                if (not rowMatches) {
+                    break;
+                }
+            }
+            for (int dv = 0; dv < height; ++dv) {
+                for (int du = 0; du < width; ++du) {
+                    cellAt(u + du, v + dv) = CubeType::NONE;
+                }
+            }
+            quadsByType[static_cast<int>(type)].push_back(
+                {face, slice, u, v, width, height});
+            u += width - 1;
+        }
+    }
+}
+
+/** Texture coordinates of a face corner at local position pos, matching
+ * the per-face layout of the instanced cube and repeating once per block. */
+glm::vec2 texCoordAt(int normalAxis, const glm::vec3& pos) {
+    if (normalAxis == 0) {
+        return {HALF_BLOCK - pos.z, pos.y + HALF_BLOCK};
+    }
+    if (normalAxis == 1) {
+        return {pos.x + HALF_BLOCK, HALF_BLOCK - pos.z};
+    }
+    return {pos.x + HALF_BLOCK, pos.y + HALF_BLOCK};
+}
+
+void appendQuad(const Quad& quad, const glm::vec3& chunkOrigin,
+                ChunkMesh& mesh) {
+    const auto& axes = FACE_AXES[quad.face];
+    glm::vec3 normal{0.0f};
+    normal[axes.normalAxis] = axes.planeOffset > 0.0f ? 1.0f : -1.0f;
+
+    const float u0{quad.u - HALF_BLOCK};
+    const float u1{quad.u + quad.width - HALF_BLOCK};
+    const float v0{quad.v - HALF_BLOCK};
+    const float v1{quad.v + quad.height - HALF_BLOCK};
+    std::array<glm::vec2, 4> corners{{{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}}};
+    if (axes.reversed) {
+        std::swap(corners[1], corners[3]);
+    }
+
+    const auto baseIndex = static_cast<unsigned>(mesh.quadVertices.size());
+    for (const auto& corner : corners) {
+        glm::vec3 local{0.0f};
+        local[axes.normalAxis] = quad.slice + axes.planeOffset;
+        local[axes.uAxis] = corner.x;
+        local[axes.vAxis] = corner.y;
+        mesh.quadVertices.push_back({chunkOrigin + local,
+                                     texCoordAt(axes.normalAxis, local),
+                                     normal});
+    }
+    mesh.quadIndices.insert(mesh.quadIndices.end(),
+                            {baseIndex, baseIndex + 1, baseIndex + 2,
+                             baseIndex + 2, baseIndex + 3, baseIndex});
+}
+} // namespace
+
+void GreedyMesher::buildQuads(const VoxelTypes::VoxelGrid3D& grid,
+                              const ChunkFaceMasks& masks,
+                              const glm::vec3& chunkOrigin, ChunkMesh& mesh) {
+    QuadsByType quadsByType{};
+    SliceCells cells{};
+    for (int face = 0; face < ChunkFaceMasks::FACE_COUNT; ++face) {
+        for (int slice = 0; slice < CHUNK_SIZE; ++slice) {
+            if (fillSlice(grid, masks, static_cast<Face>(face), slice,
+                          cells)) {
+                mergeSlice(static_cast<Face>(face), slice, cells,
+                           quadsByType);
+            }
+        }
+    }
+
+    for (std::size_t id = 0; id < quadsByType.size(); ++id) {
+        const auto& quads = quadsByType[id];
+        if (quads.empty()) {
+            continue;
+        }
+        ChunkMesh::QuadRange range{
+            static_cast<unsigned>(mesh.quadIndices.size()), 0};
+        for (const auto& quad : quads) {
+            appendQuad(quad, chunkOrigin, mesh);
+        }
+        range.indexCount =
+            static_cast<unsigned>(mesh.quadIndices.size()) - range.firstIndex;
+        mesh.quadRanges[static_cast<CubeType>(id)] = range;
+    }
+}
@@ -1,43 +1,34 @@
 #include "GridGenerator.hpp"
+#include <algorithm>
+#include <array>
 
 namespace {
-CubeType getCubeTypeBasedOnHeight(int y) {
-    if (y < 11)
-        return CubeType::SAND;
-    else if (y < 14)
-        return CubeType::DIRT;
-    else
-        return CubeType::GRASS;
-}
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
 } // namespace
 
-GridGenerator::GridGenerator(int size, int worldXIndex, int worldZIndex)
-    : chunkSize(size),
-      chunkWorldXIndex(worldXIndex),
-      chunkWorldZIndex(worldZIndex) {
-    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    noise.SetFrequency(0.02f);
-}
+GridGenerator::GridGenerator(const ChunkCoord& coord) : chunkCoord(coord) {}
 
-VoxelTypes::VoxelGrid3D GridGenerator::generateGrid() {
-    VoxelTypes::VoxelGrid3D grid(
-        chunkSize,
-        std::vector<std::vector<CubeType>>(
-            chunkSize, std::vector<CubeType>(chunkSize, CubeType::NONE)));
+VoxelTypes::VoxelGrid3D GridGenerator::generateGrid(ChunkHeightmap& heightmap) {
+    VoxelTypes::VoxelGrid3D grid(CubeType::NONE);
+    std::array<CubeType, CHUNK_SIZE> column{};
+    const auto originX = ChunkGeometry::toWorldOrigin(chunkCoord.x);
+    const auto originY = ChunkGeometry::toWorldOrigin(chunkCoord.y);
+    const auto originZ = ChunkGeometry::toWorldOrigin(chunkCoord.z);
 
-    for (int x = 0; x < chunkSize; x++) {
-        for (int z = 0; z < chunkSize; z++) {
-            const auto worldCubeX = chunkWorldXIndex * chunkSize + x;
-            const auto worldCubeZ = chunkWorldZIndex * chunkSize + z;
-            const auto heightValue = noise.GetNoise(
-                static_cast<float>(worldCubeX), static_cast<float>(worldCubeZ));
-            const auto height =
-                static_cast<int>((heightValue + 1.1f) * 0.7f * chunkSize / 2) -
-                3;
-            for (int y = 0; y < chunkSize; y++) {
-                if (y <= height) grid[x][z][y] = getCubeTypeBasedOnHeight(y);
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            const auto height = heightField.heightAt(originX + x, originZ + z);
+            const auto filledHeight =
+                std::clamp(height + 1 - originY, 0, CHUNK_SIZE);
+            for (int y = 0; y < filledHeight; y++) {
+                column[y] = TerrainHeightField::blockTypeAt(originY + y);
             }
+            std::fill(column.begin() + filledHeight, column.end(),
+                      CubeType::NONE);
+            grid.writeColumn(x, z, column.data());
+            heightmap.setSurface(x, z, filledHeight);
         }
     }
+    grid.compact();
     return grid;
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "HorizonMeshBuilder.hpp"
+#include <algorithm>
+#include <array>
+#include <glm/geometric.hpp>
+
+namespace {
+constexpr int SAMPLE_STEP{HorizonMeshBuilder::SAMPLE_STEP};
+/** Samples along one edge of a tile, both corners included. */
+constexpr int SAMPLES{HorizonMeshBuilder::TILE_SIZE / SAMPLE_STEP + 1};
+/** One more sample past each edge, for the normals along it. */
+constexpr int PADDED_SAMPLES{SAMPLES + 2};
+/** From a block's center up to its top face. */
+constexpr float BLOCK_HALF_HEIGHT{0.5f};
+
+constexpr glm::vec3 SAND_COLOR{0.86f, 0.80f, 0.58f};
+constexpr glm::vec3 DIRT_COLOR{0.53f, 0.38f, 0.26f};
+constexpr glm::vec3 GRASS_COLOR{0.36f, 0.58f, 0.24f};
+constexpr glm::vec3 WATER_COLOR{0.18f, 0.36f, 0.66f};
+
+glm::vec3 colorOf(int height) {
+    if (height < TerrainHeightField::SEA_LEVEL) {
+        return WATER_COLOR;
+    }
+    switch (TerrainHeightField::blockTypeAt(height)) {
+        case CubeType::SAND:
+            return SAND_COLOR;
+        case CubeType::DIRT:
+            return DIRT_COLOR;
+        default:
+            return GRASS_COLOR;
+    }
+}
+} // namespace
+
+CpuHorizonMesh HorizonMeshBuilder::buildTile(
+    const TerrainHeightField& heightField, int tileX, int tileZ) {
+    const int originX{tileX * TILE_SIZE};
+    const int originZ{tileZ * TILE_SIZE};
+    // Padded sample (i, j) lies at sample (i - 1, j - 1) of the tile.
+    std::array<int, PADDED_SAMPLES * PADDED_SAMPLES> heights{};
+    for (int i = 0; i < PADDED_SAMPLES; ++i) {
+        for (int j = 0; j < PADDED_SAMPLES; ++j) {
+            heights[i * PADDED_SAMPLES + j] =
+                heightField.heightAt(originX + (i - 1) * SAMPLE_STEP,
+                                     originZ + (j - 1) * SAMPLE_STEP);
+        }
+    }
+    const auto surfaceAt = [&heights](int i, int j) {
+        const auto height = heights[i * PADDED_SAMPLES + j];
+        return static_cast<float>(
+                   std::max(height, TerrainHeightField::SEA_LEVEL)) +
+               BLOCK_HALF_HEIGHT;
+    };
+
+    CpuHorizonMesh mesh{};
+    mesh.vertices.reserve(SAMPLES * SAMPLES);
+    float lowest{surfaceAt(1, 1)};
+    float highest{lowest};
+    for (int i = 1; i <= SAMPLES; ++i) {
+        for (int j = 1; j <= SAMPLES; ++j) {
+            const auto surface = surfaceAt(i, j);
+            lowest = std::min(lowest, surface);
+            highest = std::max(highest, surface);
+            // Central differences over the samples on either side.
+            const glm::vec3 normal{surfaceAt(i - 1, j) - surfaceAt(i + 1, j),
+                                   2.0f * SAMPLE_STEP,
+                                   surfaceAt(i, j - 1) - surfaceAt(i, j + 1)};
+            mesh.vertices.push_back(
+                {{static_cast<float>(originX + (i - 1) * SAMPLE_STEP), surface,
+                  static_cast<float>(originZ + (j - 1) * SAMPLE_STEP)},
+                 glm::normalize(normal),
+                 colorOf(heights[i * PADDED_SAMPLES + j])});
+        }
+    }
+
+    constexpr int CELLS{SAMPLES - 1};
+    mesh.indices.reserve(CELLS * CELLS * 6);
+    for (int i = 0; i < CELLS; ++i) {
+        for (int j = 0; j < CELLS; ++j) {
+            // Counter-clockwise seen from above.
+            const auto corner = static_cast<unsigned>(i * SAMPLES + j);
+            const auto nextZ = corner + 1;
+            const auto nextX = corner + SAMPLES;
+            const auto opposite = nextX + 1;
+            mesh.indices.insert(mesh.indices.end(), {corner, nextZ, nextX,
+                                                     nextX, nextZ, opposite});
+        }
+    }
+    mesh.boundsMin = {static_cast<float>(originX), lowest,
+                      static_cast<float>(originZ)};
+    mesh.boundsMax = {static_cast<float>(originX + TILE_SIZE), highest,
+                      static_cast<float>(originZ + TILE_SIZE)};
+    return mesh;
+}
@@ -0,0 +1,98 @@
+#include "HorizonTiles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <glm/vector_relational.hpp>
+#include "ChunkGeometry.hpp"
+#include "HorizonMeshBuilder.hpp"
+
+namespace {
+/** Tiles kept around the camera's own on every side: 2048 blocks, four
+ * times the chunk window. */
+constexpr int HORIZON_RADIUS{4};
+/** Tiles built per update, so that crossing into a new tile spreads its
+ * row of new tiles over a few frames. */
+constexpr std::size_t TILES_BUILT_PER_UPDATE{2};
+/** From a block's center to its faces. */
+constexpr float BLOCK_HALF_SIZE{0.5f};
+
+int chebyshevDistance(const std::pair<int, int>& from,
+                      const std::pair<int, int>& to) {
+    return std::max(std::abs(to.first - from.first),
+                    std::abs(to.second - from.second));
+}
+} // namespace
+
+void HorizonTiles::update(const glm::vec3& cameraPosition,
+                          const ChunkWindow& window) {
+    using ChunkGeometry::toWorldOrigin;
+    chunkAreaMin = glm::vec3{toWorldOrigin(window.minX),
+                             toWorldOrigin(window.minY),
+                             toWorldOrigin(window.minZ)} -
+                   BLOCK_HALF_SIZE;
+    chunkAreaMax = glm::vec3{toWorldOrigin(window.maxX + 1),
+                             toWorldOrigin(window.maxY + 1),
+                             toWorldOrigin(window.maxZ + 1)} -
+                   BLOCK_HALF_SIZE;
+
+    const TileKey cameraTile{
+        HorizonMeshBuilder::toTileIndex(
+            static_cast<int>(std::floor(cameraPosition.x))),
+        HorizonMeshBuilder::toTileIndex(
+            static_cast<int>(std::floor(cameraPosition.z)))};
+    std::erase_if(tiles, [&cameraTile](const auto& entry) {
+        return chebyshevDistance(cameraTile, entry.first) > HORIZON_RADIUS;
+    });
+    buildMissingTiles(cameraTile);
+}
+
+void HorizonTiles::buildMissingTiles(const TileKey& cameraTile) {
+    std::vector<TileKey> missing{};
+    for (int tileX = cameraTile.first - HORIZON_RADIUS;
+         tileX <= cameraTile.first + HORIZON_RADIUS; ++tileX) {
+        for (int tileZ = cameraTile.second - HORIZON_RADIUS;
+             tileZ <= cameraTile.second + HORIZON_RADIUS; ++tileZ) {
+            if (not tiles.contains({tileX, tileZ})) {
+                missing.push_back({tileX, tileZ});
+            }
+        }
+    }
+    const auto count = std::min(missing.size(), TILES_BUILT_PER_UPDATE);
+    std::partial_sort(missing.begin(), missing.begin() + count, missing.end(),
+                      [&cameraTile](const TileKey& a, const TileKey& b) {
+                          return chebyshevDistance(cameraTile, a) <
+                                 chebyshevDistance(cameraTile, b);
+                      });
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& key = missing[i];
+        tiles.emplace(key, Tile{RenderableHorizonTile{
+                               HorizonMeshBuilder::buildTile(
+                                   heightField, key.first, key.second)}});
+    }
+}
+
+void HorizonTiles::performFrustumCulling(const Frustum& frustum) {
+    for (auto& [key, tile] : tiles) {
+        tile.isCulled = not frustum.isAABBInside(tile.mesh.getBoundsMin(),
+                                                 tile.mesh.getBoundsMax());
+    }
+}
+
+bool HorizonTiles::isHiddenByChunks(const Tile& tile) const {
+    const auto min = tile.mesh.getBoundsMin();
+    const auto max = tile.mesh.getBoundsMax();
+    return glm::all(glm::greaterThanEqual(min, chunkAreaMin)) and
+           glm::all(glm::lessThanEqual(max, chunkAreaMax));
+}
+
+void HorizonTiles::render(Shader& shader) {
+    shader.use();
+    shader.setVec3("chunkAreaMin", chunkAreaMin);
+    shader.setVec3("chunkAreaMax", chunkAreaMax);
+    for (const auto& [key, tile] : tiles) {
+        if (not tile.isCulled and not isHiddenByChunks(tile)) {
+            tile.mesh.render();
+        }
+    }
+}
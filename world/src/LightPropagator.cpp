@@ -1,84 +1,98 @@
 #include "LightPropagator.hpp"
+#include <algorithm>
+#include "BlockRegistry.hpp"
 
 namespace {
-constexpr int PADDING{2};
-VoxelTypes::VoxelGrid3D createEmptyVoxelGrid(size_t size) {
-    return {size, std::vector<std::vector<CubeType>>(
-                      size, std::vector<CubeType>(size, CubeType::NONE))};
-}
-VoxelTypes::LightGrid3D createEmptyLightGrid(size_t size) {
-    return {size, std::vector<std::vector<float>>(
-                      size, std::vector<float>(size, 0.0f))};
-}
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int PADDED_SIZE{ChunkGeometry::PADDED_CHUNK_SIZE};
+constexpr int SECTION_SIZE{VoxelTypes::VoxelGrid3D::SECTION_SIZE};
 } // namespace
 
-LightPropagator::LightPropagator(int chunkSize, float attenuationFactor)
-    : originalSize(chunkSize),
-      paddedSize(chunkSize + PADDING),
-      attenuation(attenuationFactor) {
-    paddedVoxels = createEmptyVoxelGrid(paddedSize);
-    paddedLight = createEmptyLightGrid(paddedSize);
-}
+LightPropagator::LightPropagator(float attenuationFactor)
+    : attenuation(attenuationFactor),
+      paddedVoxels(CubeType::NONE),
+      paddedLight(0.0f) {}
 
 std::vector<float> LightPropagator::computeLightMask(
     const VoxelTypes::VoxelGrid3D& originalVoxelGrid,
     const std::vector<glm::ivec3>& torchPositions,
-    const VoxelTypes::NeighborVoxelsMap& neighborsSurroundingCubes) {
+    const ChunkHalo& neighborHalo) {
+    const bool hasLightSources{not torchPositions.empty() or
+                               neighborHalo.containsLightSource()};
+    if (not hasLightSources) {
+        return std::vector<float>(ChunkGeometry::CHUNK_VOLUME, 0.0f);
+    }
     clearPaddedGrids();
     emplaceChunkIntoPaddedGrid(originalVoxelGrid);
-    insertNeighborsSurroundingCubes(neighborsSurroundingCubes);
+    insertNeighborHalo(neighborHalo);
     seedChunkInternalTorches(torchPositions);
     runPropagation();
     return extractFinalChunkWithSeededLight();
 }
 
 void LightPropagator::clearPaddedGrids() {
-    for (int x = 0; x < paddedSize; ++x) {
-        for (int z = 0; z < paddedSize; ++z) {
-            for (int y = 0; y < paddedSize; ++y) {
-                paddedVoxels[x][z][y] = CubeType::NONE;
-                paddedLight[x][z][y] = 0.0f;
-            }
-        }
-    }
+    paddedVoxels.fill(CubeType::NONE);
+    paddedLight.fill(0.0f);
     std::queue<glm::ivec3> empty;
     std::swap(bfsQueue, empty);
 }
 
 void LightPropagator::emplaceChunkIntoPaddedGrid(
     const VoxelTypes::VoxelGrid3D& original) {
-    for (int x = 0; x < originalSize; ++x) {
-        for (int z = 0; z < originalSize; ++z) {
-            for (int y = 0; y < originalSize; ++y) {
-                paddedVoxels[x + 1][z + 1][y + 1] = original[x][z][y];
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            auto* paddedColumn = paddedVoxels.column(x + 1, z + 1) + 1;
+            for (int y = 0; y < CHUNK_SIZE; y += SECTION_SIZE) {
+                if (const auto* run = original.sectionColumnAt({x, y, z})) {
+                    std::copy_n(run, SECTION_SIZE, paddedColumn + y);
+                } else if (original(x, y, z) != CubeType::NONE) {
+                    std::fill_n(paddedColumn + y, SECTION_SIZE,
+                                original(x, y, z));
+                }
             }
         }
     }
 }
 
-void LightPropagator::insertNeighborsSurroundingCubes(
-    const VoxelTypes::NeighborVoxelsMap& neighborCubes) {
-    for (const auto& [position, cubeType] : neighborCubes) {
-        if (!isPositionWithinBounds(position, paddedSize)) {
-            continue;
+void LightPropagator::insertNeighborHalo(const ChunkHalo& halo) {
+    halo.forEachColumn([this](int paddedX, int paddedZ,
+                              const CubeType* cells) {
+        std::copy_n(cells, CHUNK_SIZE,
+                    paddedVoxels.column(paddedX, paddedZ) + 1);
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+            insertHaloCell({paddedX, y + 1, paddedZ}, cells[y]);
         }
-        paddedVoxels[position.x][position.z][position.y] = cubeType;
-        if (cubeType == CubeType::TORCH) {
-            paddedLight[position.x][position.z][position.y] = 1.0f;
-            bfsQueue.push(position);
+    });
+    const auto* below = halo.layer(ChunkHalo::BELOW);
+    const auto* above = halo.layer(ChunkHalo::ABOVE);
+    for (int x = 0; x < PADDED_SIZE; ++x) {
+        for (int z = 0; z < PADDED_SIZE; ++z) {
+            const auto index = ChunkHalo::layerIndexOf(x, z);
+            insertHaloCell({x, 0, z}, below[index]);
+            insertHaloCell({x, PADDED_SIZE - 1, z}, above[index]);
         }
     }
 }
 
+void LightPropagator::insertHaloCell(const glm::ivec3& paddedPos,
+                                     CubeType type) {
+    paddedVoxels[paddedPos] = type;
+    if (BlockRegistry::isEmissive(type)) {
+        paddedLight[paddedPos] = BlockRegistry::getEmission(type);
+        bfsQueue.push(paddedPos);
+    }
+}
+
 void LightPropagator::seedChunkInternalTorches(
     const std::vector<glm::ivec3>& torches) {
     for (const auto& local : torches) {
         const glm::ivec3 paddedGridOffset{1, 1, 1};
         const glm::ivec3 paddedPos = local + paddedGridOffset;
-        if (!isPositionWithinBounds(paddedPos, paddedSize)) {
+        if (!isPositionWithinBounds(paddedPos, PADDED_SIZE)) {
             continue;
         }
-        paddedLight[paddedPos.x][paddedPos.z][paddedPos.y] = 1.0f;
+        paddedLight[paddedPos] = BlockRegistry::getEmission(
+            paddedVoxels[paddedPos]);
         bfsQueue.push(paddedPos);
     }
 }
@@ -89,7 +103,7 @@ void LightPropagator::runPropagation() {
         bfsQueue.pop();
 
         const auto currentLightValue =
-            paddedLight[currentPos.x][currentPos.z][currentPos.y];
+            paddedLight[currentPos];
         if (currentLightValue < 0.01f) {
             continue;
         }
@@ -103,32 +117,31 @@ void LightPropagator::propagateToNeighbors(const glm::ivec3& position,
                                            float nextLightValue) {
     for (const auto& offset : NEIGHBOR_OFFSETS) {
         glm::ivec3 neighborPos = position + offset;
-        if (!isPositionWithinBounds(neighborPos, paddedSize)) {
+        if (!isPositionWithinBounds(neighborPos, PADDED_SIZE)) {
             continue;
         }
 
         auto& currentNeighborLightValue =
-            paddedLight[neighborPos.x][neighborPos.z][neighborPos.y];
+            paddedLight[neighborPos];
         if (nextLightValue <= currentNeighborLightValue) {
             continue;
         }
 
         currentNeighborLightValue = nextLightValue;
-        if (paddedVoxels[neighborPos.x][neighborPos.z][neighborPos.y] ==
-            CubeType::NONE) {
+        if (BlockRegistry::transmitsLight(paddedVoxels[neighborPos])) {
             bfsQueue.push(neighborPos);
         }
     }
 }
 
 std::vector<float> LightPropagator::extractFinalChunkWithSeededLight() {
-    std::vector<float> out;
-    out.reserve(originalSize * originalSize * originalSize);
+    std::vector<float> out(ChunkGeometry::CHUNK_VOLUME);
 
-    for (int z = 1; z <= originalSize; ++z) {
-        for (int y = 1; y <= originalSize; ++y) {
-            for (int x = 1; x <= originalSize; ++x) {
-                out.push_back(paddedLight[x][z][y]);
+    auto outCell = out.begin();
+    for (int z = 1; z <= CHUNK_SIZE; ++z) {
+        for (int y = 1; y <= CHUNK_SIZE; ++y) {
+            for (int x = 1; x <= CHUNK_SIZE; ++x) {
+                *outCell++ = paddedLight(x, y, z);
             }
         }
     }
@@ -0,0 +1,80 @@
+#include "LodDownsampler.hpp"
+#include <algorithm>
+#include <array>
+#include "BlockRegistry.hpp"
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr int MAX_SCALE{LodDownsampler::scaleOf(LodLevel::QUARTER)};
+using Column = std::array<CubeType, CHUNK_SIZE>;
+
+/** The most common solid type in the highest layer of the cell starting at
+ * firstY that holds a solid block, NONE when no layer does. */
+CubeType surfaceTypeOf(const Column* columns, int columnCount, int firstY,
+                       int scale) {
+    std::array<int, BlockRegistry::BLOCK_TYPE_COUNT> tally{};
+    for (int y = firstY + scale - 1; y >= firstY; --y) {
+        CubeType best{CubeType::NONE};
+        for (int i = 0; i < columnCount; ++i) {
+            const auto type = columns[i][y];
+            if (not BlockRegistry::isSolid(type)) {
+                continue;
+            }
+            const auto count = ++tally[static_cast<std::size_t>(type)];
+            if (best == CubeType::NONE or
+                count > tally[static_cast<std::size_t>(best)]) {
+                best = type;
+            }
+        }
+        if (best != CubeType::NONE) {
+            return best;
+        }
+    }
+    return CubeType::NONE;
+}
+} // namespace
+
+VoxelTypes::VoxelGrid3D LodDownsampler::downsample(
+    const VoxelTypes::VoxelGrid3D& grid, const ChunkHeightmap& heightmap,
+    LodLevel level) {
+    const int scale{scaleOf(level)};
+    const int columnCount{scale * scale};
+    VoxelTypes::VoxelGrid3D coarse{};
+    std::array<Column, MAX_SCALE * MAX_SCALE> columns{};
+    // Local y of the highest solid block of each column, -1 for none.
+    std::array<int, MAX_SCALE * MAX_SCALE> tops{};
+    Column coarseColumn{};
+    for (int cellX = 0; cellX < CHUNK_SIZE; cellX += scale) {
+        for (int cellZ = 0; cellZ < CHUNK_SIZE; cellZ += scale) {
+            for (int i = 0; i < columnCount; ++i) {
+                const int x{cellX + i / scale};
+                const int z{cellZ + i % scale};
+                grid.readColumn(x, z, columns[i].data());
+                tops[i] = heightmap.surfaceAt(x, z) - 1;
+            }
+            for (int cellY = 0; cellY < CHUNK_SIZE; cellY += scale) {
+                int solidCount{0};
+                int topCount{0};
+                for (int i = 0; i < columnCount; ++i) {
+                    solidCount += static_cast<int>(std::count_if(
+                        columns[i].cbegin() + cellY,
+                        columns[i].cbegin() + cellY + scale,
+                        BlockRegistry::isSolid));
+                    topCount += tops[i] >= cellY and tops[i] < cellY + scale;
+                }
+                const bool solid{2 * solidCount >= columnCount * scale or
+                                 2 * topCount >= columnCount};
+                std::fill_n(coarseColumn.begin() + cellY, scale,
+                            solid ? surfaceTypeOf(columns.data(), columnCount,
+                                                  cellY, scale)
+                                  : CubeType::NONE);
+            }
+            for (int i = 0; i < columnCount; ++i) {
+                coarse.writeColumn(cellX + i / scale, cellZ + i % scale,
+                                   coarseColumn.data());
+            }
+        }
+    }
+    coarse.compact();
+    return coarse;
+}
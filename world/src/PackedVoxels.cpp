@@ -0,0 +1,130 @@
+#include "PackedVoxels.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+namespace {
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+constexpr std::size_t CUBE_TYPE_COUNT{
+    std::numeric_limits<std::underlying_type_t<CubeType>>::max() + 1};
+
+std::size_t typeSlot(CubeType type) { return static_cast<std::size_t>(type); }
+
+using Column = std::array<CubeType, CHUNK_SIZE>;
+
+bool isUniformColumn(const Column& column) {
+    return std::all_of(column.cbegin(), column.cend(),
+                       [first = column[0]](CubeType type) {
+                           return type == first;
+                       });
+}
+} // namespace
+
+PackedVoxels::PackedVoxels(const VoxelTypes::VoxelGrid3D& grid) {
+    buildPalette(grid);
+    packColumns(grid);
+}
+
+void PackedVoxels::buildPalette(const VoxelTypes::VoxelGrid3D& grid) {
+    std::array<bool, CUBE_TYPE_COUNT> used{};
+    Column column{};
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            grid.readColumn(x, z, column.data());
+            for (const auto type : column) {
+                used[typeSlot(type)] = true;
+            }
+        }
+    }
+    for (std::size_t slot = 0; slot < CUBE_TYPE_COUNT; ++slot) {
+        if (used[slot]) {
+            palette.push_back(static_cast<CubeType>(slot));
+        }
+    }
+    palette.shrink_to_fit();
+    bitsPerIndex = static_cast<int>(std::bit_width(palette.size() - 1));
+}
+
+void PackedVoxels::packColumns(const VoxelTypes::VoxelGrid3D& grid) {
+    std::array<std::uint8_t, CUBE_TYPE_COUNT> paletteIndexOf{};
+    for (std::size_t i = 0; i < palette.size(); ++i) {
+        paletteIndexOf[typeSlot(palette[i])] = static_cast<std::uint8_t>(i);
+    }
+
+    Column column{};
+    std::uint16_t mixedColumns{0};
+    columnEntries.reserve(static_cast<std::size_t>(CHUNK_SIZE) * CHUNK_SIZE);
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            grid.readColumn(x, z, column.data());
+            if (isUniformColumn(column)) {
+                columnEntries.push_back(UNIFORM_COLUMN |
+                                        paletteIndexOf[typeSlot(column[0])]);
+                continue;
+            }
+            auto bitOffset = columnBitOffset(mixedColumns);
+            columnEntries.push_back(mixedColumns++);
+            const auto columnEnd = columnBitOffset(mixedColumns);
+            packedIndices.resize((columnEnd + WORD_BITS - 1) / WORD_BITS, 0);
+            for (const auto type : column) {
+                writeIndex(bitOffset, paletteIndexOf[typeSlot(type)]);
+                bitOffset += bitsPerIndex;
+            }
+        }
+    }
+    packedIndices.shrink_to_fit();
+}
+
+VoxelTypes::VoxelGrid3D PackedVoxels::unpack() const {
+    VoxelTypes::VoxelGrid3D grid(CubeType::NONE);
+    Column column{};
+    auto entry = columnEntries.cbegin();
+    for (int x = 0; x < CHUNK_SIZE; ++x) {
+        for (int z = 0; z < CHUNK_SIZE; ++z, ++entry) {
+            if (*entry & UNIFORM_COLUMN) {
+                std::fill(column.begin(), column.end(),
+                          palette[*entry & ~UNIFORM_COLUMN]);
+            } else {
+                auto bitOffset = columnBitOffset(*entry);
+                for (auto& type : column) {
+                    type = palette[readIndex(bitOffset)];
+                    bitOffset += bitsPerIndex;
+                }
+            }
+            grid.writeColumn(x, z, column.data());
+        }
+    }
+    grid.compact();
+    return grid;
+}
+
+std::size_t PackedVoxels::getResidentBytes() const {
+    return sizeof(*this) + palette.capacity() * sizeof(CubeType) +
+           columnEntries.capacity() * sizeof(std::uint16_t) +
+           packedIndices.capacity() * sizeof(Word);
+}
+
+std::size_t PackedVoxels::columnBitOffset(std::uint16_t packedColumn) const {
+    return static_cast<std::size_t>(packedColumn) * CHUNK_SIZE * bitsPerIndex;
+}
+
+void PackedVoxels::writeIndex(std::size_t bitOffset, unsigned index) {
+    const auto word = bitOffset / WORD_BITS;
+    const auto shift = static_cast<int>(bitOffset % WORD_BITS);
+    packedIndices[word] |= static_cast<Word>(index) << shift;
+    if (shift + bitsPerIndex > WORD_BITS) {
+        packedIndices[word + 1] |=
+            static_cast<Word>(index) >> (WORD_BITS - shift);
+    }
+}
+
+unsigned PackedVoxels::readIndex(std::size_t bitOffset) const {
+    const auto word = bitOffset / WORD_BITS;
+    const auto shift = static_cast<int>(bitOffset % WORD_BITS);
+    auto bits = packedIndices[word] >> shift;
+    if (shift + bitsPerIndex > WORD_BITS) {
+        bits |= packedIndices[word + 1] << (WORD_BITS - shift);
+    }
+    return static_cast<unsigned>(bits & ((Word{1} << bitsPerIndex) - 1));
+}
@@ -0,0 +1,96 @@
+#include "RetainedMesh.hpp"
+#include <algorithm>
+
+namespace {
+constexpr int SECTION_COUNT{ChunkMesh::SECTION_COUNT};
+
+bool isDark(const std::vector<float>& lightVolume) {
+    return std::all_of(lightVolume.cbegin(), lightVolume.cend(),
+                       [](float light) { return light == 0.0f; });
+}
+
+/** Replaces the instances of the sections patch covers, per block type. */
+void replaceSections(ChunkMesh& mesh, const ChunkMesh& patch) {
+    static const ChunkMesh::SectionCounts NO_COUNTS{};
+    static const std::vector<glm::vec3> NO_POSITIONS{};
+    for (const auto& [type, counts] : patch.sectionInstanceCounts) {
+        // Types new to the chunk start out with no instances.
+        mesh.sectionInstanceCounts.try_emplace(type);
+    }
+    for (auto& [type, counts] : mesh.sectionInstanceCounts) {
+        const auto patchCounts = patch.sectionInstanceCounts.find(type);
+        const auto& newCounts =
+            patchCounts != patch.sectionInstanceCounts.cend()
+                ? patchCounts->second
+                : NO_COUNTS;
+        const auto patchPositions = patch.instancePositions.find(type);
+        const auto& newPositions =
+            patchPositions != patch.instancePositions.cend()
+                ? patchPositions->second
+                : NO_POSITIONS;
+        auto& positions = mesh.instancePositions[type];
+        std::vector<glm::vec3> merged{};
+        merged.reserve(positions.size() + newPositions.size());
+        // Both lists hold their sections one after another, in order.
+        auto kept = positions.cbegin();
+        auto replacing = newPositions.cbegin();
+        for (int section = 0; section < SECTION_COUNT; ++section) {
+            if ((patch.sections >> section) & 1) {
+                merged.insert(merged.end(), replacing,
+                              replacing + newCounts[section]);
+                replacing += newCounts[section];
+                kept += counts[section];
+                counts[section] = newCounts[section];
+            } else {
+                merged.insert(merged.end(), kept, kept + counts[section]);
+                kept += counts[section];
+            }
+        }
+        positions = std::move(merged);
+    }
+}
+} // namespace
+
+void RetainedMesh::apply(CubeData&& data) {
+    version = data.version;
+    if (data.scope == RebuildScope::SECTIONS) {
+        replaceSections(mesh, data.mesh);
+        heightmap = data.heightmap;
+        return;
+    }
+    mesh = std::move(data.mesh);
+    if (data.scope == RebuildScope::MESH) {
+        return;
+    }
+    if (isDark(data.lightVolume)) {
+        lightVolume.clear();
+        lightVolume.shrink_to_fit();
+    } else {
+        lightVolume = std::move(data.lightVolume);
+    }
+    waterMesh = std::move(data.waterMesh);
+    heightmap = data.heightmap;
+}
+
+void RetainedMesh::compact() {
+    for (auto& [type, positions] : mesh.instancePositions) {
+        positions.shrink_to_fit();
+    }
+    mesh.quadVertices.shrink_to_fit();
+    mesh.quadIndices.shrink_to_fit();
+}
+
+std::size_t RetainedMesh::getResidentBytes() const {
+    std::size_t bytes{sizeof(*this)};
+    for (const auto& [type, positions] : mesh.instancePositions) {
+        bytes += positions.capacity() * sizeof(glm::vec3);
+    }
+    bytes += mesh.sectionInstanceCounts.size() *
+             sizeof(ChunkMesh::SectionCounts);
+    bytes += mesh.quadVertices.capacity() * sizeof(Vertex) +
+             mesh.quadIndices.capacity() * sizeof(unsigned);
+    bytes += lightVolume.capacity() * sizeof(float);
+    bytes += waterMesh.getVertices().capacity() * sizeof(Vertex) +
+             waterMesh.getIndices().capacity() * sizeof(unsigned int);
+    return bytes;
+}
@@ -0,0 +1,41 @@
+#include "SavedChunk.hpp"
+
+namespace {
+std::vector<SavedChunk::VoxelEdit> toEditList(
+    const VoxelTypes::VoxelEditsMap& edits) {
+    std::vector<SavedChunk::VoxelEdit> editList;
+    editList.reserve(edits.size());
+    for (const auto& [position, type] : edits) {
+        editList.push_back({static_cast<std::uint8_t>(position.x),
+                            static_cast<std::uint8_t>(position.y),
+                            static_cast<std::uint8_t>(position.z), type});
+    }
+    return editList;
+}
+} // namespace
+
+SavedChunk::SavedChunk(const VoxelTypes::VoxelEditsMap& edits,
+                       BlockStateTable states)
+    : contents{toEditList(edits)}, blockStates{std::move(states)} {}
+
+SavedChunk::SavedChunk(PackedVoxels&& packedVoxels, BlockStateTable states)
+    : contents{std::move(packedVoxels)}, blockStates{std::move(states)} {}
+
+const std::vector<SavedChunk::VoxelEdit>* SavedChunk::getEdits() const {
+    return std::get_if<std::vector<VoxelEdit>>(&contents);
+}
+
+const PackedVoxels* SavedChunk::getPackedVoxels() const {
+    return std::get_if<PackedVoxels>(&contents);
+}
+
+std::size_t SavedChunk::getResidentBytes() const {
+    const auto stateBytes =
+        blockStates.getResidentBytes() - sizeof(BlockStateTable);
+    if (const auto* packedVoxels = getPackedVoxels()) {
+        return sizeof(*this) - sizeof(PackedVoxels) +
+               packedVoxels->getResidentBytes() + stateBytes;
+    }
+    return sizeof(*this) + getEdits()->capacity() * sizeof(VoxelEdit) +
+           stateBytes;
+}
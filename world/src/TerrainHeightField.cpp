@@ -0,0 +1,23 @@
+#include "TerrainHeightField.hpp"
+#include "ChunkGeometry.hpp"
+
+TerrainHeightField::TerrainHeightField() {
+    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    noise.SetFrequency(0.02f);
+}
+
+int TerrainHeightField::heightAt(int worldX, int worldZ) const {
+    constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+    const auto heightValue = noise.GetNoise(static_cast<float>(worldX),
+                                            static_cast<float>(worldZ));
+    return static_cast<int>((heightValue + 1.1f) * 0.7f * CHUNK_SIZE / 2) - 3;
+}
+
+CubeType TerrainHeightField::blockTypeAt(int worldY) {
+    if (worldY < 11)
+        return CubeType::SAND;
+    else if (worldY < 14)
+        return CubeType::DIRT;
+    else
+        return CubeType::GRASS;
+}
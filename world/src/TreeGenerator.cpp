@@ -1,28 +1,36 @@
 #include "TreeGenerator.hpp"
-#include <cstdlib>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 
-TreeGenerator::TreeGenerator(int size) : chunkSize{size} {}
+namespace {
+constexpr float TREE_PROBABILITY{0.02f};
+constexpr int MIN_TRUNK_HEIGHT{4};
+constexpr int MAX_TRUNK_HEIGHT{7};
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
 
-int TreeGenerator::findHighestFilledVoxelY(
-    const VoxelTypes::VoxelGrid3D& voxelGrid, int x, int z) const {
-    for (int y = chunkSize - 1; y >= 0; y--) {
-        if (voxelGrid[x][z][y] != CubeType::NONE) return y;
-    }
-    return -1;
+constexpr int MIN_TREE_BASE_HEIGHT{16};
+
+std::uint32_t seedForChunk(const ChunkCoord& chunkCoord) {
+    return static_cast<std::uint32_t>(hashChunkCoord(chunkCoord));
 }
+} // namespace
+
+TreeGenerator::TreeGenerator(const ChunkCoord& chunkCoord)
+    : random{seedForChunk(chunkCoord)},
+      chunkOriginY{ChunkGeometry::toWorldOrigin(chunkCoord.y)} {}
 
 void TreeGenerator::placeTreeTrunkAt(int x, int highestFilledY, int z,
                                      VoxelTypes::VoxelGrid3D& voxelGrid) {
     int trunkBaseY = highestFilledY + 1;
-    const int trunkHeight = 4 + (rand() % 4);
+    const int trunkHeight = std::uniform_int_distribution<int>{
+        MIN_TRUNK_HEIGHT, MAX_TRUNK_HEIGHT}(random);
     for (int i = 0; i < trunkHeight; i++) {
         int newY = trunkBaseY + i;
-        if (newY < chunkSize) {
+        if (newY < CHUNK_SIZE) {
             glm::ivec3 pos{x, newY, z};
             trunkPositions.insert(pos);
-            voxelGrid[x][z][newY] = CubeType::LOG;
+            voxelGrid.set(pos, CubeType::LOG);
         }
     }
 }
@@ -38,27 +46,26 @@ void TreeGenerator::generateCrownForTrunk(int colX, int colZ, int trunkTopY,
                 if (squaredDistance <= 1 or squaredDistance > 4) continue;
                 glm::ivec3 crownPos{colX + offsetX, trunkTopY + offsetY,
                                     colZ + offsetZ};
-                if (crownPos.x < 0 or crownPos.x >= chunkSize or
-                    crownPos.y < 0 or crownPos.y >= chunkSize or
-                    crownPos.z < 0 or crownPos.z >= chunkSize) {
+                if (not ChunkGeometry::isWithinChunk(crownPos)) {
                     continue;
                 }
                 crownPositions.insert(crownPos);
-                voxelGrid[crownPos.x][crownPos.z][crownPos.y] =
-                    CubeType::LEAVES;
+                voxelGrid.set(crownPos, CubeType::LEAVES);
             }
         }
     }
 }
 
-void TreeGenerator::generateNewTreeTrunks(VoxelTypes::VoxelGrid3D& voxelGrid) {
-    for (int x = 0; x < chunkSize; x++) {
-        for (int z = 0; z < chunkSize; z++) {
-            const auto highestY = findHighestFilledVoxelY(voxelGrid, x, z);
-            if (highestY > 16) {
+void TreeGenerator::generateNewTreeTrunks(VoxelTypes::VoxelGrid3D& voxelGrid,
+                                          const ChunkHeightmap& heightmap) {
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            const auto highestY = heightmap.surfaceAt(x, z) - 1;
+            if (highestY >= 0 and
+                chunkOriginY + highestY > MIN_TREE_BASE_HEIGHT) {
                 const auto probability =
-                    static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-                if (probability < 0.02f) {
+                    std::uniform_real_distribution<float>{0.0f, 1.0f}(random);
+                if (probability < TREE_PROBABILITY) {
                     placeTreeTrunkAt(x, highestY, z, voxelGrid);
                 }
             }
@@ -99,39 +106,17 @@ void TreeGenerator::generateCrownsForTrunks(
     }
 }
 
-void TreeGenerator::generateTrees(VoxelTypes::VoxelGrid3D& voxelGrid) {
-    if (trunkPositions.empty()) {
-        generateNewTreeTrunks(voxelGrid);
+void TreeGenerator::generateTrees(VoxelTypes::VoxelGrid3D& voxelGrid,
+                                  const ChunkHeightmap& heightmap) {
+    if (not treesGenerated) {
+        generateNewTreeTrunks(voxelGrid, heightmap);
+        treesGenerated = true;
     }
     const auto trunks = buildTrunksMapping();
     generateCrownsForTrunks(trunks, voxelGrid);
 }
 
-void TreeGenerator::reapplyTrunks(
-    float initialCubeX, float initialCubeZ,
-    const std::function<void(const glm::ivec3&, CubeType)>& createCubeCallback)
-    const {
-    for (const auto& pos : trunkPositions) {
-        if (pos.y < chunkSize) {
-            const glm::ivec3 worldPos{initialCubeX + pos.x, pos.y,
-                                      initialCubeZ + pos.z};
-            createCubeCallback(worldPos, CubeType::LOG);
-        }
-    }
-}
-
-void TreeGenerator::reapplyCrowns(
-    float initialCubeX, float initialCubeZ,
-    const std::function<void(const glm::ivec3&, CubeType)>& createCubeCallback)
-    const {
-    for (const auto& pos : crownPositions) {
-        if (pos.y < chunkSize) {
-            const glm::ivec3 worldPos{initialCubeX + pos.x, pos.y,
-                                      initialCubeZ + pos.z};
-            createCubeCallback(worldPos, CubeType::LEAVES);
-        }
-    }
-}
+void TreeGenerator::markTreesGenerated() { treesGenerated = true; }
 
 void TreeGenerator::removeTreeCubeAt(const glm::ivec3& localPos) {
     trunkPositions.erase(localPos);
@@ -1,101 +1,144 @@
 #include "World.hpp"
+#include "BlockRegistry.hpp"
 #include "Raycaster.hpp"
 #include "VertexData.hpp"
 #include "ChunkCoord.hpp"
 #include "NeighborCubesGatherer.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <cmath>
+#include <optional>
+#include <unordered_set>
+#include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace {
-constexpr int CHUNK_SIZE{64};
-ChunkWindow computeChunkWindow(const ChunkCoord& cameraChunk,
-                               int renderDistance) {
-    return {cameraChunk.x - renderDistance, cameraChunk.x + renderDistance,
-            cameraChunk.z - renderDistance, cameraChunk.z + renderDistance};
+constexpr int CHUNK_SIZE{ChunkGeometry::CHUNK_SIZE};
+/** How far past a ring a chunk must be before it changes level, so that
+ * chunks along a ring do not flip between levels as the camera wobbles. */
+constexpr float LOD_HYSTERESIS{16.0f};
+
+/** Calls visit(coord) for the 26 chunks around center. */
+template <typename Visitor>
+void forEachNeighborCoord(const ChunkCoord& center, Visitor&& visit) {
+    for (int offsetX = -1; offsetX <= 1; ++offsetX) {
+        for (int offsetY = -1; offsetY <= 1; ++offsetY) {
+            for (int offsetZ = -1; offsetZ <= 1; ++offsetZ) {
+                if (offsetX != 0 or offsetY != 0 or offsetZ != 0) {
+                    visit(ChunkCoord{center.x + offsetX, center.y + offsetY,
+                                     center.z + offsetZ});
+                }
+            }
+        }
+    }
+}
+
+/** Calls visit(coord) for the chunks sharing a face with center. */
+template <typename Visitor>
+void forEachFaceNeighborCoord(const ChunkCoord& center, Visitor&& visit) {
+    for (const auto& offset : NEIGHBOR_OFFSETS) {
+        visit(ChunkCoord{center.x + offset.x, center.y + offset.y,
+                         center.z + offset.z});
+    }
+}
+
+/** Calls visit(coord) for the face neighbors of center whose border cells
+ * face the local box [localMin, localMax] of center. */
+template <typename Visitor>
+void forEachBorderNeighborCoord(const ChunkCoord& center,
+                                const glm::ivec3& localMin,
+                                const glm::ivec3& localMax, Visitor&& visit) {
+    for (const auto& offset : NEIGHBOR_OFFSETS) {
+        const auto axis = offset.x != 0 ? 0 : (offset.y != 0 ? 1 : 2);
+        const bool touchesFace{offset[axis] < 0
+                                   ? localMin[axis] == 0
+                                   : localMax[axis] == CHUNK_SIZE - 1};
+        if (touchesFace) {
+            visit(ChunkCoord{center.x + offset.x, center.y + offset.y,
+                             center.z + offset.z});
+        }
+    }
 }
 } // namespace
 
 void World::loadInitialChunks() {
     std::lock_guard<std::mutex> lock(loadedChunksMutex);
-    for (int x = -renderDistance; x <= renderDistance; ++x) {
-        for (int z = -renderDistance; z <= renderDistance; ++z) {
-            ChunkCoord coord{x, z};
-            auto chunk = chunkLoader->createChunk(x, z);
-            loadedChunks[coord] = std::move(chunk);
-            chunkUpdaters[coord] =
-                std::make_unique<ChunkUpdater>(loadedChunks[coord].get());
+    const auto& window = windowIndex.getWindow();
+    for (int x = window.minX; x <= window.maxX; ++x) {
+        for (int z = window.minZ; z <= window.maxZ; ++z) {
+            for (int y = window.minY; y <= window.maxY; ++y) {
+                const ChunkCoord coord{x, y, z};
+                auto& slot = chunks.findOrInsert(coord);
+                slot.renderable = chunkLoader->createChunk(coord);
+                slot.renderable->setMeshingMode(meshingMode);
+                windowIndex.insert(coord, slot.renderable.get());
+                slot.updater =
+                    std::make_unique<ChunkUpdater>(slot.renderable.get());
+            }
         }
     }
 }
 
 World::World() {
     printf("World::Init!\n");
-    chunkLoader = std::make_unique<ChunkLoader>(renderDistance, CHUNK_SIZE);
+    chunkLoader = std::make_unique<ChunkLoader>();
     loadInitialChunks();
-    lastCameraChunk = {0, 0};
+    lastCameraChunk = {0, 0, 0};
 }
 
 bool World::addCubeFromRaycast(const Camera& camera, float maxDistance,
                                CubeType type) {
-    const auto hitOpt =
-        Raycaster{camera, CHUNK_SIZE}.raycastDDA(loadedChunks, maxDistance);
+    const auto hitOpt = Raycaster{camera}.raycastDDA(windowIndex, maxDistance);
     if (not hitOpt.has_value()) {
         return false;
     }
 
     const auto hit = hitOpt.value();
     const auto newCubePos = hit.position + hit.normal;
-    const auto chunkX = floorDivide(newCubePos.x, CHUNK_SIZE);
-    const auto chunkZ = floorDivide(newCubePos.z, CHUNK_SIZE);
-    auto* chunk = getChunk({chunkX, chunkZ});
+    const auto chunkCoord = fromWorldPosition(newCubePos);
+    auto* chunk = getChunk(chunkCoord);
     if (not chunk) {
         return false;
     }
 
-    const auto localX = negativeSafeModulo(newCubePos.x, CHUNK_SIZE);
-    const auto localZ = negativeSafeModulo(newCubePos.z, CHUNK_SIZE);
-    const auto localY = newCubePos.y;
-
-    bool added = chunk->addCube({localX, localY, localZ}, type);
-    if (added and type == CubeType::TORCH) {
-        notifyNeighborChunks({chunkX, chunkZ});
+    const auto localPos = toLocalPosition(newCubePos);
+    bool added = chunk->addCube(localPos, type);
+    if (added and BlockRegistry::isEmissive(type)) {
+        notifyNeighborChunks(chunkCoord);
+    }
+    if (added) {
+        notifyBorderNeighbors(chunkCoord, localPos, localPos);
     }
     return added;
 }
 
 bool World::removeCubeFromRaycast(const Camera& camera, float maxDistance) {
-    auto hitOpt =
-        Raycaster{camera, CHUNK_SIZE}.raycastDDA(loadedChunks, maxDistance);
+    auto hitOpt = Raycaster{camera}.raycastDDA(windowIndex, maxDistance);
     if (not hitOpt.has_value()) {
         return false;
     }
 
     const auto hit = hitOpt.value();
     const auto worldCubePos = hit.position;
-    const auto chunkX = floorDivide(worldCubePos.x, CHUNK_SIZE);
-    const auto chunkZ = floorDivide(worldCubePos.z, CHUNK_SIZE);
-    auto* chunk = getChunk({chunkX, chunkZ});
+    const auto chunkCoord = fromWorldPosition(worldCubePos);
+    auto* chunk = getChunk(chunkCoord);
     if (not chunk) {
         return false;
     }
 
-    const auto localX = negativeSafeModulo(worldCubePos.x, CHUNK_SIZE);
-    const auto localZ = negativeSafeModulo(worldCubePos.z, CHUNK_SIZE);
-    const auto localY = worldCubePos.y;
-
-    if (chunk->getCubeType({localX, localY, localZ}) == CubeType::TORCH) {
-        notifyNeighborChunks({chunkX, chunkZ});
+    const auto localPos = toLocalPosition(worldCubePos);
+    if (BlockRegistry::isEmissive(chunk->getCubeType(localPos))) {
+        notifyNeighborChunks(chunkCoord);
+    }
+    const bool removed = chunk->removeCube(localPos);
+    if (removed) {
+        notifyBorderNeighbors(chunkCoord, localPos, localPos);
     }
-    return chunk->removeCube({localX, localY, localZ});
+    return removed;
 }
 
 RenderableChunk* World::getChunk(const ChunkCoord& coord) const {
-    const auto it = loadedChunks.find(coord);
-    if (it != loadedChunks.cend()) {
-        return it->second.get();
-    }
-    return nullptr;
+    return windowIndex.find(coord);
 }
 
 bool World::updateCameraChunk(const ChunkCoord& currentCamCoord) {
@@ -107,213 +150,576 @@ bool World::updateCameraChunk(const ChunkCoord& currentCamCoord) {
     return false;
 }
 
-std::unordered_set<ChunkCoord, PositionXYHash> World::getLoadedChunkKeys() {
-    std::unordered_set<ChunkCoord, PositionXYHash> keys;
+std::unordered_set<ChunkCoord, ChunkCoordHash> World::getLoadedChunkKeys() {
+    std::unordered_set<ChunkCoord, ChunkCoordHash> keys;
     std::lock_guard<std::mutex> lock(loadedChunksMutex);
-    for (const auto& [chunkCoord, _] : loadedChunks) {
-        keys.insert(chunkCoord);
-    }
+    chunks.forEachRenderable(
+        [&keys](const ChunkCoord& coord, RenderableChunk&) {
+            keys.insert(coord);
+        });
     return keys;
 }
 
 void World::mergeNewChunks(Coord::CpuChunksMap& newChunks) {
     std::lock_guard<std::mutex> lock(loadedChunksMutex);
     for (auto& [coord, newCpuChunk] : newChunks) {
-        auto [it, inserted] = loadedChunks.try_emplace(coord, nullptr);
-        if (inserted) {
-            auto& newGpuChunk = it->second;
-            newGpuChunk = newCpuChunk->toRenderable(
-                chunkLoader->getSharedVBO(), chunkLoader->getSharedEBO(),
-                chunkLoader->getSharedWaterEBO());
-            chunkUpdaters[coord] =
-                std::make_unique<ChunkUpdater>(it->second.get());
+        auto& slot = chunks.findOrInsert(coord);
+        // A chunk evicted while the task ran keeps its save; the task's
+        // fresh copy would lose its edits.
+        if (slot.renderable or slot.saved) {
+            continue;
         }
+        slot.renderable = newCpuChunk->toRenderable(
+            chunkLoader->getSharedVBO(), chunkLoader->getSharedEBO(),
+            chunkLoader->getSharedWaterEBO());
+        slot.renderable->setMeshingMode(meshingMode);
+        slot.updater = std::make_unique<ChunkUpdater>(slot.renderable.get());
+        windowIndex.insert(coord, slot.renderable.get());
+        adoptRetainedMesh(coord, *slot.renderable);
+        notifyFaceNeighbors(coord);
     }
 }
 
 void World::reloadCurrentlyRelevantChunkGroup(
     const ChunkCoord& currentCamCoord) {
-    const auto isCameraMoved = updateCameraChunk(currentCamCoord);
-    const auto existingKeys = getLoadedChunkKeys();
-    if (chunkLoader->isTaskRunning() and chunkLoader->isFinished()) {
+    // A window that moved while the task ran is loaded by the next one.
+    isWindowLoadPending |= updateCameraChunk(currentCamCoord);
+    if (chunkLoader->isTaskRunning()) {
+        // The nearest chunks are merged while the task builds the rest.
         auto newChunks = chunkLoader->retrieveNewChunks();
         mergeNewChunks(newChunks);
     }
-    if (isCameraMoved and not chunkLoader->isTaskRunning()) {
-        chunkLoader->launchTask(currentCamCoord.x, currentCamCoord.z,
-                                existingKeys);
+    if (isWindowLoadPending and not chunkLoader->isTaskRunning()) {
+        isWindowLoadPending = false;
+        const auto existingKeys = getLoadedChunkKeys();
+        chunkLoader->launchTask(windowIndex.getWindow(), currentCamCoord,
+                                existingKeys,
+                                takeSavedChunks(windowIndex.getWindow()));
     }
 }
 
-void World::restoreSavedChunks(const ChunkWindow& window) {
-    auto savedChunk = savedChunks.begin();
-    while (savedChunk != savedChunks.end()) {
-        const auto chunkCoord = savedChunk->first;
-        if (isChunkWithinWindow(chunkCoord, window)) {
-            restoreSavedChunk(chunkCoord, savedChunk);
-        } else {
-            ++savedChunk;
+ChunkLoader::SavedChunks World::takeSavedChunks(const ChunkWindow& window) {
+    std::lock_guard<std::mutex> lock(loadedChunksMutex);
+    ChunkLoader::SavedChunks savedChunks;
+    chunks.forEach([&](const ChunkCoord& coord, ChunkSlot& slot) {
+        if (slot.saved and isChunkWithinWindow(coord, window)) {
+            savedChunks.emplace(coord, std::move(*slot.saved));
+            slot.saved.reset();
         }
-    }
-}
-
-void World::restoreSavedChunk(const ChunkCoord& coord,
-                              Coord::CpuChunksMap::iterator& savedChunk) {
-    auto restoredRenderable = savedChunk->second->toRenderable(
-        chunkLoader->getSharedVBO(), chunkLoader->getSharedEBO(),
-        chunkLoader->getSharedWaterEBO());
-
-    loadedChunks.emplace(coord, std::move(restoredRenderable));
-    chunkUpdaters[coord] =
-        std::make_unique<ChunkUpdater>(loadedChunks[coord].get());
-    savedChunk = savedChunks.erase(savedChunk);
+    });
+    return savedChunks;
 }
 
 void World::evictOutOfRangeChunks(const ChunkWindow& window) {
-    auto loadedChunk = loadedChunks.begin();
-    while (loadedChunk != loadedChunks.end()) {
-        const auto chunkCoord = loadedChunk->first;
-        if (shouldEvictLoadedChunk(chunkCoord, window)) {
-            evictLoadedChunk(chunkCoord, loadedChunk);
-        } else {
-            ++loadedChunk;
+    chunks.forEach([&](const ChunkCoord& coord, ChunkSlot& slot) {
+        if (slot.renderable and shouldEvictLoadedChunk(coord, slot, window)) {
+            retainMesh(coord, *slot.renderable);
         }
-    }
+    });
+    chunks.forEach([&](const ChunkCoord& coord, ChunkSlot& slot) {
+        if (slot.renderable and shouldEvictLoadedChunk(coord, slot, window)) {
+            evictLoadedChunk(coord, slot);
+            chunks.eraseIfEmpty(coord);
+        }
+    });
 }
 
 bool World::shouldEvictLoadedChunk(const ChunkCoord& coord,
+                                   const ChunkSlot& slot,
                                    const ChunkWindow& window) const {
-    bool outsideX = (coord.x < window.minX || coord.x > window.maxX);
-    bool outsideZ = (coord.z < window.minZ || coord.z > window.maxZ);
-    const bool isWithinWindow{!(outsideX || outsideZ)};
-    if (isWithinWindow) {
+    if (isChunkWithinWindow(coord, window)) {
         return false;
     }
-    auto updaterIt = chunkUpdaters.find(coord);
-    if (updaterIt != chunkUpdaters.end() &&
-        updaterIt->second->isUpdateRunning()) {
+    if (slot.updater && slot.updater->isUpdateRunning()) {
         return false;
     }
     return true;
 }
 
-void World::evictLoadedChunk(
-    const ChunkCoord& coord,
-    Coord::RenderableChunksMap::iterator& loadedChunk) {
-    auto cpuChunk = loadedChunk->second->toCpuChunk();
-    savedChunks[coord] = std::move(cpuChunk);
+void World::evictLoadedChunk(const ChunkCoord& coord, ChunkSlot& slot) {
+    windowIndex.erase(coord);
+    notifyFaceNeighbors(coord);
+    slot.saved = slot.renderable->save();
+    slot.updater.reset();
+    slot.renderable.reset();
+}
 
-    auto chunkUpdater = chunkUpdaters.find(coord);
-    if (chunkUpdater != chunkUpdaters.end()) {
-        chunkUpdaters.erase(chunkUpdater);
+void World::retainMesh(const ChunkCoord& coord, RenderableChunk& chunk) {
+    if (auto mesh = chunk.releaseMesh()) {
+        mesh->loadedNeighbors = findLoadedNeighbors(coord);
+        meshCache.insert(coord, std::move(*mesh));
     }
-    loadedChunk = loadedChunks.erase(loadedChunk);
 }
 
-void World::adjustLoadedChunks(const ChunkCoord& currentCamCoord) {
-    const auto window = computeChunkWindow(currentCamCoord, renderDistance);
+void World::adoptRetainedMesh(const ChunkCoord& coord,
+                              RenderableChunk& chunk) {
+    auto mesh = meshCache.take(coord);
+    if (not mesh or mesh->meshingMode != meshingMode) {
+        return;
+    }
+    const auto meshedNeighbors = mesh->loadedNeighbors;
+    const auto meshedSeams = mesh->openBorderFaces;
+    chunk.adoptMesh(std::move(*mesh));
+
+    const auto loadedNeighbors = findLoadedNeighbors(coord);
+    const auto absent = meshedNeighbors & ~loadedNeighbors;
+    // Neighbors the mesh was built against that are not loaded yet are on
+    // their way if they are inside the window, and gone for good if not.
+    ChunkFaceMasks::FaceSet pending{0};
+    ChunkFaceMasks::FaceSet missing{0};
+    int face{0};
+    forEachFaceNeighborCoord(coord, [&](const ChunkCoord& near) {
+        const auto bit = ChunkFaceMasks::FaceSet{1} << face++;
+        if ((absent & bit) == 0) {
+            return;
+        }
+        if (isChunkWithinWindow(near, windowIndex.getWindow())) {
+            pending |= bit;
+        } else {
+            missing |= bit;
+        }
+    });
+    chunk.assumeNeighbors(pending);
+    const bool seamsMoved{chunk.getLodLevel() == LodLevel::FULL and
+                          findSeamFaces(coord, chunk) != meshedSeams};
+    if ((loadedNeighbors & ~meshedNeighbors) != 0 or missing != 0 or
+        seamsMoved) {
+        chunk.markBorderModified();
+    }
+}
 
+void World::adjustLoadedChunks(const ChunkCoord& currentCamCoord) {
     std::lock_guard<std::mutex> lock(loadedChunksMutex);
-    restoreSavedChunks(window);
-    evictOutOfRangeChunks(window);
+    windowIndex.recenter(currentCamCoord);
+    evictOutOfRangeChunks(windowIndex.getWindow());
 }
 
 void World::runUpdatePerChunk() {
-    for (auto& [coord, updater] : chunkUpdaters) {
-        const auto chunk = getChunk(coord);
-        if (chunk and chunk->isModified() and !updater->isUpdateRunning()) {
+    chunks.forEach([](const ChunkCoord&, ChunkSlot& slot) {
+        if (not slot.updater) {
+            return;
+        }
+        const auto& updater = slot.updater;
+        if (slot.renderable->isModified() and !updater->isUpdateRunning()) {
             updater->launchUpdate();
         }
         updater->checkAndApplyUpdate();
-    }
+    });
 }
 void World::setCameraPosition(const glm::vec3& camPos) {
     cameraPosition = camPos;
 }
 
 void World::updateLoadedChunks() {
-    const auto camChunkX =
-        static_cast<int>(std::floor(cameraPosition.x / CHUNK_SIZE));
-    const auto camChunkZ =
-        static_cast<int>(std::floor(cameraPosition.z / CHUNK_SIZE));
-    ChunkCoord currentCamCoord{camChunkX, camChunkZ};
+    const auto currentCamCoord =
+        fromWorldPosition(glm::ivec3(glm::floor(cameraPosition)));
 
     adjustLoadedChunks(currentCamCoord);
     reloadCurrentlyRelevantChunkGroup(currentCamCoord);
+    updateLodLevels();
     injectNeighborsToModifiedChunks();
     runUpdatePerChunk();
+    horizon.update(cameraPosition, windowIndex.getWindow());
 }
 
 void World::injectNeighborsToModifiedChunks() {
-    for (auto& [coord, chunk] : loadedChunks) {
-        if (chunk->isModified()) {
-            auto neighborData =
-                NeighborGatherer{CHUNK_SIZE}.gatherNeighborsForCoord(
-                    coord, [this](const ChunkCoord& chunkCoord) {
-                        return this->getChunk(chunkCoord);
-                    });
-            chunk->setNeighborsSurroundingCubes(std::move(neighborData));
+    chunks.forEachRenderable([this](const ChunkCoord& coord,
+                                    RenderableChunk& chunk) {
+        if (chunk.isModified()) {
+            NeighborGatherer{}.gatherHaloForCoord(coord, windowIndex,
+                                                  neighborHalo);
+            chunk.setNeighborHalo(neighborHalo);
+            chunk.setOpenBorderFaces(findSeamFaces(coord, chunk));
         }
-    }
+    });
+}
+
+void World::performFrustumCulling(const Frustum& frustum,
+                                  const Frustum& horizonFrustum) {
+    chunks.forEachRenderable([&frustum](const ChunkCoord&,
+                                        RenderableChunk& chunk) {
+        chunk.performFrustumCulling(frustum);
+    });
+    horizon.performFrustumCulling(horizonFrustum);
+}
+
+bool World::isWithinDrawDistance(const ChunkCoord& coord) const {
+    // Coarse levels keep the whole loaded window affordable to draw; chunks
+    // still loaded past it would overlap the horizon.
+    return isChunkWithinWindow(coord, windowIndex.getWindow());
 }
 
-void World::performFrustumCulling(const Frustum& frustum) {
-    for (auto& [_, chunk] : loadedChunks) {
-        chunk->performFrustumCulling(frustum);
+LodLevel World::chooseLodLevel(const RenderableChunk& chunk) const {
+    const auto distance = glm::length(chunk.getChunkCenter() - cameraPosition);
+    const auto current = static_cast<std::size_t>(chunk.getLodLevel());
+    std::size_t level{0};
+    for (std::size_t ring = 0; ring < lodRingDistances.size(); ++ring) {
+        // Ring i separates level i from level i + 1.
+        const auto margin = ring < current ? -LOD_HYSTERESIS : LOD_HYSTERESIS;
+        if (distance > lodRingDistances[ring] + margin) {
+            level = ring + 1;
+        }
     }
+    return static_cast<LodLevel>(level);
+}
+
+void World::updateLodLevels() {
+    chunks.forEachRenderable([this](const ChunkCoord& coord,
+                                    RenderableChunk& chunk) {
+        const auto previous = chunk.getLodLevel();
+        const auto level = chooseLodLevel(chunk);
+        if (level == previous) {
+            return;
+        }
+        chunk.setLodLevel(level);
+        // Coarse chunks keep all their border faces anyway; only full-detail
+        // neighbors cull theirs against this chunk.
+        if (previous != LodLevel::FULL and level != LodLevel::FULL) {
+            return;
+        }
+        forEachFaceNeighborCoord(coord, [this](const ChunkCoord& near) {
+            auto* neighbor = getChunk(near);
+            if (neighbor and neighbor->getLodLevel() == LodLevel::FULL) {
+                neighbor->markBorderModified();
+            }
+        });
+    });
+}
+
+ChunkFaceMasks::FaceSet World::findLoadedNeighbors(
+    const ChunkCoord& coord) const {
+    ChunkFaceMasks::FaceSet loaded{0};
+    int face{0};
+    forEachFaceNeighborCoord(coord, [&](const ChunkCoord& near) {
+        if (getChunk(near)) {
+            loaded |= ChunkFaceMasks::FaceSet{1} << face;
+        }
+        ++face;
+    });
+    return loaded;
+}
+
+ChunkFaceMasks::FaceSet World::findSeamFaces(
+    const ChunkCoord& coord, const RenderableChunk& chunk) const {
+    ChunkFaceMasks::FaceSet seams{0};
+    int face{0};
+    // Face neighbors come in ChunkFaceMasks::Face order.
+    forEachFaceNeighborCoord(coord, [&](const ChunkCoord& near) {
+        const auto* neighbor = getChunk(near);
+        if (neighbor and neighbor->getLodLevel() != chunk.getLodLevel()) {
+            seams |= ChunkFaceMasks::FaceSet{1} << face;
+        }
+        ++face;
+    });
+    return seams;
+}
+
+void World::setLodRingDistances(float halfDetail, float quarterDetail) {
+    lodRingDistances = {halfDetail, quarterDetail};
+}
+
+void World::setMeshCacheBudget(std::size_t bytes) {
+    meshCache.setBudget(bytes);
 }
 
 void World::renderByType(Shader& shader, CubeType type) {
     shader.use();
-    const auto maxRenderDistSq = 200.f * 200.f;
-    for (auto& [_, chunk] : loadedChunks) {
-        const auto chunkCenter = chunk->getChunkCenter();
-        const auto distSq = glm::dot(chunkCenter - cameraPosition,
-                                     chunkCenter - cameraPosition);
-        if (distSq > maxRenderDistSq) {
-            continue;
+    chunks.forEachRenderable([&](const ChunkCoord& coord,
+                                  RenderableChunk& chunk) {
+        if (isWithinDrawDistance(coord)) {
+            chunk.renderByType(shader, type);
         }
-        chunk->renderByType(shader, type);
-    }
+    });
 }
 
 void World::renderWaterMeshes(Shader& shader) {
     shader.use();
-    const auto maxRenderDistSq = 200.f * 200.f;
-    for (auto& [_, chunk] : loadedChunks) {
-        const auto chunkCenter = chunk->getChunkCenter();
-        const auto distSq = glm::dot(chunkCenter - cameraPosition,
-                                     chunkCenter - cameraPosition);
-        if (distSq > maxRenderDistSq) {
-            continue;
+    chunks.forEachRenderable([&](const ChunkCoord& coord,
+                                  RenderableChunk& chunk) {
+        if (isWithinDrawDistance(coord)) {
+            chunk.renderWaterMeshes(shader);
         }
-        chunk->renderWaterMeshes(shader);
-    }
+    });
+}
+
+void World::renderHorizon(Shader& shader) { horizon.render(shader); }
+
+void World::setMeshingMode(MeshingMode mode) {
+    std::lock_guard<std::mutex> lock(loadedChunksMutex);
+    meshingMode = mode;
+    meshCache.clear();
+    chunks.forEachRenderable([mode](const ChunkCoord&, RenderableChunk& chunk) {
+        chunk.setMeshingMode(mode);
+    });
+}
+
+std::size_t World::countRenderedTriangles() {
+    std::size_t triangles{0};
+    chunks.forEachRenderable([&](const ChunkCoord& coord,
+                                  RenderableChunk& chunk) {
+        if (isWithinDrawDistance(coord)) {
+            triangles += chunk.getTriangleCount();
+        }
+    });
+    return triangles;
 }
 
 void World::notifyNeighborChunks(const ChunkCoord& centerCoord) {
-    for (int offsetX = -1; offsetX <= 1; ++offsetX) {
-        for (int offsetZ = -1; offsetZ <= 1; ++offsetZ) {
-            if (offsetX == 0 && offsetZ == 0) {
-                continue;
+    forEachNeighborCoord(centerCoord, [this](const ChunkCoord& coord) {
+        if (auto* neighbor = getChunk(coord)) {
+            neighbor->markModified();
+        } else {
+            meshCache.erase(coord);
+        }
+    });
+}
+
+void World::notifyFaceNeighbors(const ChunkCoord& centerCoord) {
+    int face{0};
+    forEachFaceNeighborCoord(centerCoord, [&](const ChunkCoord& coord) {
+        // The neighbor sees this chunk across the opposite face.
+        const auto facing = face++ ^ 1;
+        auto* neighbor = getChunk(coord);
+        if (neighbor and not neighbor->consumeAssumedNeighbor(facing)) {
+            neighbor->markBorderModified();
+        }
+    });
+}
+
+void World::notifyBorderNeighbors(const ChunkCoord& centerCoord,
+                                  const glm::ivec3& localMin,
+                                  const glm::ivec3& localMax) {
+    forEachBorderNeighborCoord(centerCoord, localMin, localMax,
+                               [this](const ChunkCoord& coord) {
+                                   if (auto* neighbor = getChunk(coord)) {
+                                       neighbor->markBorderModified();
+                                   } else {
+                                       meshCache.erase(coord);
+                                   }
+                               });
+}
+
+template <typename CellRule>
+std::size_t World::editRegion(const glm::ivec3& min, const glm::ivec3& max,
+                              CellRule&& rule) {
+    const auto firstChunk = fromWorldPosition(min);
+    const auto lastChunk = fromWorldPosition(max);
+    std::vector<VoxelTypes::VoxelWrite> writes;
+    std::unordered_set<ChunkCoord, ChunkCoordHash> neighborsToNotify;
+    std::unordered_set<ChunkCoord, ChunkCoordHash> bordersToNotify;
+    std::size_t changedCount{0};
+    for (int chunkX = firstChunk.x; chunkX <= lastChunk.x; ++chunkX) {
+        for (int chunkZ = firstChunk.z; chunkZ <= lastChunk.z; ++chunkZ) {
+            for (int chunkY = firstChunk.y; chunkY <= lastChunk.y; ++chunkY) {
+                const ChunkCoord coord{chunkX, chunkY, chunkZ};
+                auto* chunk = getChunk(coord);
+                if (not chunk) {
+                    continue;
+                }
+                const glm::ivec3 origin{ChunkGeometry::toWorldOrigin(chunkX),
+                                        ChunkGeometry::toWorldOrigin(chunkY),
+                                        ChunkGeometry::toWorldOrigin(chunkZ)};
+                const auto localMin = glm::max(min - origin, glm::ivec3{0});
+                const auto localMax =
+                    glm::min(max - origin, glm::ivec3{CHUNK_SIZE - 1});
+                writes.clear();
+                for (int x = localMin.x; x <= localMax.x; ++x) {
+                    for (int z = localMin.z; z <= localMax.z; ++z) {
+                        for (int y = localMin.y; y <= localMax.y; ++y) {
+                            const glm::ivec3 localPos{x, y, z};
+                            const auto type =
+                                rule(origin + localPos,
+                                     chunk->getCubeType(localPos));
+                            if (type.has_value()) {
+                                writes.push_back({localPos, *type});
+                            }
+                        }
+                    }
+                }
+                if (writes.empty()) {
+                    continue;
+                }
+                const auto result = chunk->writeVoxels(writes);
+                changedCount += result.changedCount;
+                if (result.changedCount > 0) {
+                    forEachBorderNeighborCoord(
+                        coord, localMin, localMax,
+                        [&](const ChunkCoord& near) {
+                            bordersToNotify.insert(near);
+                        });
+                }
+                if (result.lightSourcesChanged) {
+                    forEachNeighborCoord(coord, [&](const ChunkCoord& near) {
+                        neighborsToNotify.insert(near);
+                    });
+                }
             }
-            ChunkCoord neighborCoord{centerCoord.x + offsetX,
-                                     centerCoord.z + offsetZ};
-            if (auto* neighbor = getChunk(neighborCoord)) {
-                neighbor->markModified();
+        }
+    }
+    // Kept meshes of evicted neighbors no longer match what they face.
+    for (const auto& coord : neighborsToNotify) {
+        if (auto* neighbor = getChunk(coord)) {
+            neighbor->markModified();
+        } else {
+            meshCache.erase(coord);
+        }
+    }
+    for (const auto& coord : bordersToNotify) {
+        if (auto* neighbor = getChunk(coord)) {
+            neighbor->markBorderModified();
+        } else {
+            meshCache.erase(coord);
+        }
+    }
+    return changedCount;
+}
+
+std::size_t World::fillBox(const glm::ivec3& min, const glm::ivec3& max,
+                           CubeType type) {
+    return editRegion(min, max, [type](const glm::ivec3&, CubeType) {
+        return std::optional{type};
+    });
+}
+
+std::size_t World::fillHollowSphere(const glm::ivec3& center, int radius,
+                                    CubeType type) {
+    const auto outerSq = radius * radius;
+    const auto innerSq = (radius - 1) * (radius - 1);
+    return editRegion(
+        center - glm::ivec3{radius}, center + glm::ivec3{radius},
+        [&](const glm::ivec3& pos, CubeType) -> std::optional<CubeType> {
+            const auto offset = pos - center;
+            const auto distanceSq = offset.x * offset.x +
+                                    offset.y * offset.y + offset.z * offset.z;
+            if (distanceSq > innerSq and distanceSq <= outerSq) {
+                return type;
+            }
+            return std::nullopt;
+        });
+}
+
+std::size_t World::replaceInBox(const glm::ivec3& min, const glm::ivec3& max,
+                                CubeType from, CubeType to) {
+    return editRegion(
+        min, max,
+        [from, to](const glm::ivec3&,
+                   CubeType current) -> std::optional<CubeType> {
+            if (current == from) {
+                return to;
+            }
+            return std::nullopt;
+        });
+}
+
+std::size_t World::pasteTemplate(const BlockTemplate& stamp,
+                                 const glm::ivec3& origin) {
+    return editRegion(
+        origin, origin + stamp.getSize() - 1,
+        [&](const glm::ivec3& pos, CubeType) -> std::optional<CubeType> {
+            const auto type = stamp.at(pos - origin);
+            if (type == CubeType::NONE) {
+                return std::nullopt;
+            }
+            return type;
+        });
+}
+
+BlockTemplate World::copyTemplate(const glm::ivec3& min,
+                                  const glm::ivec3& max) const {
+    BlockTemplate stamp{max - min + 1};
+    for (int x = min.x; x <= max.x; ++x) {
+        for (int z = min.z; z <= max.z; ++z) {
+            for (int y = min.y; y <= max.y; ++y) {
+                const glm::ivec3 pos{x, y, z};
+                stamp.set(pos - min, getCubeTypeAtPosition(pos));
             }
         }
     }
+    return stamp;
 }
 
 CubeType World::getCubeTypeAtPosition(const glm::ivec3& position) const {
     const auto chunkCoord = fromWorldPosition(position);
     const auto chunk = getChunk(chunkCoord);
-    if (chunk) {
-        const auto localPos = toLocalPosition(position);
+    const auto localPos = toLocalPosition(position);
+    if (chunk and ChunkGeometry::isWithinChunk(localPos)) {
         return chunk->getCubeType(localPos);
     }
     return CubeType::NONE;
 }
 
+Voxel World::getVoxelAtPosition(const glm::ivec3& position) const {
+    const auto chunk = getChunk(fromWorldPosition(position));
+    if (not chunk) {
+        return {};
+    }
+    return chunk->getVoxel(toLocalPosition(position));
+}
+
+bool World::setBlockStateAtPosition(const glm::ivec3& position,
+                                    BlockState state) {
+    const auto chunk = getChunk(fromWorldPosition(position));
+    return chunk and chunk->setBlockState(toLocalPosition(position), state);
+}
+
+bool World::isSolidAt(const glm::ivec3& position) const {
+    const auto* chunk = getChunk(fromWorldPosition(position));
+    return chunk and chunk->getOccupancy().isSolidAt(toLocalPosition(position));
+}
+
+std::optional<int> World::findLowestSolidY(int worldX, int worldZ, int minY,
+                                           int maxY) const {
+    const auto chunkX = ChunkGeometry::toChunkIndex(worldX);
+    const auto chunkZ = ChunkGeometry::toChunkIndex(worldZ);
+    const auto localX = ChunkGeometry::toLocalIndex(worldX);
+    const auto localZ = ChunkGeometry::toLocalIndex(worldZ);
+    for (int layer = ChunkGeometry::toChunkIndex(minY);
+         layer <= ChunkGeometry::toChunkIndex(maxY); ++layer) {
+        const auto* chunk = getChunk({chunkX, layer, chunkZ});
+        if (not chunk) {
+            continue;
+        }
+        const auto origin = ChunkGeometry::toWorldOrigin(layer);
+        const auto solidY = chunk->getOccupancy().lowestSolidY(
+            localX, localZ, std::max(minY - origin, 0),
+            std::min(maxY - origin, ChunkGeometry::CHUNK_SIZE - 1));
+        if (solidY.has_value()) {
+            return origin + *solidY;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<int> World::findHighestSolidY(int worldX, int worldZ, int minY,
+                                            int maxY) const {
+    const auto chunkX = ChunkGeometry::toChunkIndex(worldX);
+    const auto chunkZ = ChunkGeometry::toChunkIndex(worldZ);
+    const auto localX = ChunkGeometry::toLocalIndex(worldX);
+    const auto localZ = ChunkGeometry::toLocalIndex(worldZ);
+    for (int layer = ChunkGeometry::toChunkIndex(maxY);
+         layer >= ChunkGeometry::toChunkIndex(minY); --layer) {
+        const auto* chunk = getChunk({chunkX, layer, chunkZ});
+        if (not chunk) {
+            continue;
+        }
+        const auto origin = ChunkGeometry::toWorldOrigin(layer);
+        const auto lowestY = std::max(minY - origin, 0);
+        const auto highestY = maxY - origin;
+        if (highestY >= ChunkGeometry::CHUNK_SIZE - 1) {
+            // The range covers the top of the chunk: its heightmap answers.
+            const auto surface = chunk->getSurfaceHeight(localX, localZ);
+            if (surface > lowestY) {
+                return origin + surface - 1;
+            }
+            continue;
+        }
+        const auto solidY = chunk->getOccupancy().highestSolidY(
+            localX, localZ, lowestY, highestY);
+        if (solidY.has_value()) {
+            return origin + *solidY;
+        }
+    }
+    return std::nullopt;
+}
+
 World::~World() { std::cout << "World::Shutdown!" << std::endl; }
\ No newline at end of file